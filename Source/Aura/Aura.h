@@ -3,6 +3,13 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
 
 #define CUSTOM_DEPTH_RED 250
 
+//项目自定义的性能统计分组，游戏中使用"stat Aura"查看
+DECLARE_STATS_GROUP(TEXT("Aura"), STATGROUP_Aura, STATCAT_Advanced);
+
+//项目自定义的日志分类
+DECLARE_LOG_CATEGORY_EXTERN(LogAura, Log, All);
+
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AuraBenchmarkUtils.h"
+
+#if !UE_BUILD_SHIPPING
+#include "AbilitySystemComponent.h"
+#include "AbilitySystem/AuraAttributeSet.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Misc/Parse.h"
+
+void AuraBenchmarkUtils::ParseCounts(const TArray<FString>& Args, TConstArrayView<int32> DefaultCounts, TArray<int32>& OutCounts, const TCHAR* ValueKey, int32& InOutValue)
+{
+	OutCounts.Reset();
+	for (const FString& Arg : Args)
+	{
+		if (ValueKey && FParse::Value(*Arg, ValueKey, InOutValue))
+		{
+			continue;
+		}
+		const int32 Value = FCString::Atoi(*Arg);
+		if (Value > 0)
+		{
+			OutCounts.Add(Value);
+		}
+	}
+	InOutValue = FMath::Max(InOutValue, 1);
+	if (OutCounts.Num() == 0)
+	{
+		OutCounts.Append(DefaultCounts.GetData(), DefaultCounts.Num());
+	}
+}
+
+UAbilitySystemComponent* AuraBenchmarkUtils::SpawnAbilitySystemActor(UWorld* World)
+{
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParameters.ObjectFlags |= RF_Transient;
+	AActor* Owner = World ? World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParameters) : nullptr;
+	if (Owner == nullptr)
+	{
+		return nullptr;
+	}
+
+	// 属性集的外部对象必须是拥有者Actor，GetOwningAbilitySystemComponent才能找到这个组件
+	UAbilitySystemComponent* AbilitySystemComponent = NewObject<UAbilitySystemComponent>(Owner);
+	AbilitySystemComponent->RegisterComponent();
+	AbilitySystemComponent->AddAttributeSetSubobject(NewObject<UAuraAttributeSet>(Owner));
+	AbilitySystemComponent->InitAbilityActorInfo(Owner, Owner);
+	return AbilitySystemComponent;
+}
+#endif
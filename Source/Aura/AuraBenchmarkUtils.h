@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if !UE_BUILD_SHIPPING
+class UAbilitySystemComponent;
+class UWorld;
+
+//控制台基准共用的工具，只在非Shipping版本中编译
+namespace AuraBenchmarkUtils
+{
+	/**
+	 * 解析"[数量...] [Key=N]"形式的参数
+	 * 纯数字的参数作为要测试的数量加入OutCounts，没有时使用DefaultCounts；ValueKey（例如"Iterations="）的值写入InOutValue，至少为1
+	 * 其他参数（例如"Class="）忽略，由调用方自己解析
+	 */
+	AURA_API void ParseCounts(const TArray<FString>& Args, TConstArrayView<int32> DefaultCounts, TArray<int32>& OutCounts, const TCHAR* ValueKey, int32& InOutValue);
+
+	/**
+	 * 生成一个代替敌人的临时Actor：只带一个已注册的能力系统组件和一个UAuraAttributeSet，ActorInfo的拥有者和化身都是它自己
+	 * 返回能力系统组件，用GetOwner取得Actor，测试结束后由调用方销毁；生成失败时返回nullptr
+	 */
+	AURA_API UAbilitySystemComponent* SpawnAbilitySystemActor(UWorld* World);
+}
+#endif
@@ -3,3 +3,138 @@
 
 #include "AbilitySystem/AuraAbilitySystemComponent.h"
 
+#include "AbilitySystem/AuraAttributeSet.h"
+#include "Engine/ActorChannel.h"
+#include "Engine/NetConnection.h"
+#include "Player/AuraPlayerController.h"
+
+/**
+ * @brief 子对象复制（每个连接单独调用）
+ * 和父类实现一致，依次复制GameplayTasks、属性集、实例化的技能，只是属性集的复制会先经过复制策略的过滤
+ */
+bool UAuraAbilitySystemComponent::ReplicateSubobjects(UActorChannel* Channel, FOutBunch* Bunch, FReplicationFlags* RepFlags)
+{
+	if (!AttributeReplicationPolicy.bEnabled)
+	{
+		return Super::ReplicateSubobjects(Channel, Bunch, RepFlags);
+	}
+
+	// 跳过UAbilitySystemComponent的实现，直接调用上一层，属性集和技能在下面自己复制
+	bool bWroteSomething = UGameplayTasksComponent::ReplicateSubobjects(Channel, Bunch, RepFlags);
+
+	if (ShouldReplicateAttributesTo(Channel->Connection, *RepFlags))
+	{
+		for (const UAttributeSet* Set : GetSpawnedAttributes())
+		{
+			if (IsValid(Set))
+			{
+				bWroteSomething |= Channel->ReplicateSubobject(const_cast<UAttributeSet*>(Set), *Bunch, *RepFlags);
+			}
+		}
+	}
+
+	for (UGameplayAbility* Ability : GetReplicatedInstancedAbilities())
+	{
+		if (IsValid(Ability))
+		{
+			bWroteSomething |= Channel->ReplicateSubobject(Ability, *Bunch, *RepFlags);
+		}
+	}
+
+	return bWroteSomething;
+}
+
+bool UAuraAbilitySystemComponent::ShouldReplicateAttributesTo(UNetConnection* Connection, const FReplicationFlags& RepFlags)
+{
+	if (Connection == nullptr)
+	{
+		return true;
+	}
+
+	// 新连接加入时顺便清理已经断开的连接
+	FConnectionAttributeRepState* State = ConnectionAttributeRepStates.Find(Connection);
+	if (State == nullptr)
+	{
+		for (auto It = ConnectionAttributeRepStates.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+		State = &ConnectionAttributeRepStates.Add(Connection);
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	const int32 HealthBucket = GetHealthBucket();
+	const AActor* Avatar = GetAvatarActor();
+	const APlayerController* PlayerController = Connection->PlayerController;
+
+	// 正在进入休眠的Actor这是休眠前的最后一次复制，之后属性变化要等唤醒才会发送
+	const AActor* OwnerActor = GetOwner();
+	const bool bPendingDormancy = OwnerActor && OwnerActor->NetDormancy > DORM_Awake;
+
+	bool bShouldSend = false;
+	if (RepFlags.bNetInitial || bPendingDormancy)
+	{
+		// 首次复制必须发送，保证客户端拿到完整的初始属性；休眠前发送最新值，避免客户端停在被过滤掉的旧值上
+		bShouldSend = true;
+	}
+	else if (Avatar == nullptr || PlayerController == nullptr || HealthBucket != State->LastHealthBucket)
+	{
+		// 无法判断距离，或者血量跨过了阈值档位
+		bShouldSend = true;
+	}
+	else if (const AAuraPlayerController* AuraPlayerController = Cast<AAuraPlayerController>(PlayerController);
+		AuraPlayerController && AuraPlayerController->GetHoveredEnemy() == Avatar)
+	{
+		// 该玩家正在悬停这个敌人
+		bShouldSend = true;
+	}
+	else
+	{
+		// 俯视角相机离地面很远，用玩家控制的角色位置计算距离更准确
+		FVector ViewLocation;
+		if (const APawn* ViewPawn = PlayerController->GetPawn())
+		{
+			ViewLocation = ViewPawn->GetActorLocation();
+		}
+		else
+		{
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		}
+
+		const double DistanceSquared = FVector::DistSquared(ViewLocation, Avatar->GetActorLocation());
+		if (DistanceSquared <= FMath::Square(AttributeReplicationPolicy.FullRateDistance))
+		{
+			bShouldSend = true;
+		}
+		else
+		{
+			const float Interval = DistanceSquared <= FMath::Square(AttributeReplicationPolicy.ReducedRateDistance)
+				? AttributeReplicationPolicy.ReducedRateInterval
+				: AttributeReplicationPolicy.FarRateInterval;
+			bShouldSend = Interval > 0.0f && Now - State->LastSendTime >= Interval;
+		}
+	}
+
+	if (bShouldSend)
+	{
+		State->LastSendTime = Now;
+		State->LastHealthBucket = HealthBucket;
+	}
+	return bShouldSend;
+}
+
+int32 UAuraAbilitySystemComponent::GetHealthBucket() const
+{
+	const UAuraAttributeSet* AuraAttributeSet = GetSet<UAuraAttributeSet>();
+	if (AuraAttributeSet == nullptr || AuraAttributeSet->GetMaxHealth() <= 0.0f)
+	{
+		return INDEX_NONE;
+	}
+
+	const float Step = FMath::Max(AttributeReplicationPolicy.HealthThresholdStep, 0.01f);
+	return FMath::FloorToInt(AuraAttributeSet->GetHealth() / AuraAttributeSet->GetMaxHealth() / Step);
+}
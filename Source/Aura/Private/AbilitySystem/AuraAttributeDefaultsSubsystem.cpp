@@ -0,0 +1,220 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AbilitySystem/AuraAttributeDefaultsSubsystem.h"
+
+#include "AbilitySystemComponent.h"
+#include "AbilitySystem/AuraAttributeSet.h"
+#include "Aura/Aura.h"
+#include "Aura/AuraBenchmarkUtils.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameplayEffect.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Attribute Defaults Apply"), STAT_AuraAttributeDefaultsApply, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Attribute Defaults Applied"), STAT_AuraAttributeDefaultsApplied, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Attribute Defaults Baked"), STAT_AuraAttributeDefaultsBaked, STATGROUP_Aura);
+
+float FAuraBakedAttributeDefaults::GetValue(const FGameplayAttribute& Attribute, float DefaultValue) const
+{
+	const int32 Index = Attributes.IndexOfByKey(Attribute);
+	return Index != INDEX_NONE ? Values[Index] : DefaultValue;
+}
+
+void UAuraAttributeDefaultsSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// 表很小并且开局就要用到，直接同步加载；曲线表由FScalableFloat硬引用，会一起加载
+	if (!AttributeDefaultsTable.IsNull())
+	{
+		LoadedTable = AttributeDefaultsTable.LoadSynchronous();
+		if (LoadedTable && LoadedTable->GetRowStruct() != FAuraAttributeDefaultsRow::StaticStruct())
+		{
+			UE_LOG(LogAura, Error, TEXT("%s 的行结构不是FAuraAttributeDefaultsRow"), *LoadedTable->GetPathName());
+			LoadedTable = nullptr;
+		}
+	}
+}
+
+void UAuraAttributeDefaultsSubsystem::Deinitialize()
+{
+	SET_DWORD_STAT(STAT_AuraAttributeDefaultsBaked, 0);
+	BakedDefaults.Reset();
+	LoadedTable = nullptr;
+
+	Super::Deinitialize();
+}
+
+const FAuraBakedAttributeDefaults* UAuraAttributeDefaultsSubsystem::FindDefaults(FName DefaultsName, int32 Level)
+{
+	if (DefaultsName.IsNone() || LoadedTable == nullptr)
+	{
+		return nullptr;
+	}
+
+	const TPair<FName, int32> Key(DefaultsName, Level);
+	if (const FAuraBakedAttributeDefaults* Baked = BakedDefaults.Find(Key))
+	{
+		return Baked;
+	}
+
+	const FAuraAttributeDefaultsRow* Row = LoadedTable->FindRow<FAuraAttributeDefaultsRow>(DefaultsName, TEXT("AuraAttributeDefaults"));
+	if (Row == nullptr)
+	{
+		return nullptr;
+	}
+
+	// 第一次用到这个（角色类型，等级）时求值所有曲线，之后同类敌人直接复用
+	FAuraBakedAttributeDefaults& Baked = BakedDefaults.Add(Key);
+	Baked.Attributes.Reserve(Row->Attributes.Num());
+	Baked.Values.Reserve(Row->Attributes.Num());
+	for (const FAuraAttributeDefaultValue& Entry : Row->Attributes)
+	{
+		if (Entry.Attribute.IsValid())
+		{
+			Baked.Attributes.Add(Entry.Attribute);
+			Baked.Values.Add(Entry.Value.GetValueAtLevel(static_cast<float>(Level)));
+		}
+	}
+	SET_DWORD_STAT(STAT_AuraAttributeDefaultsBaked, BakedDefaults.Num());
+	return &Baked;
+}
+
+bool UAuraAttributeDefaultsSubsystem::ApplyDefaults(UAbilitySystemComponent* AbilitySystemComponent, FName DefaultsName, int32 Level)
+{
+	SCOPE_CYCLE_COUNTER(STAT_AuraAttributeDefaultsApply);
+
+	if (AbilitySystemComponent == nullptr)
+	{
+		return false;
+	}
+	const FAuraBakedAttributeDefaults* Defaults = FindDefaults(DefaultsName, Level);
+	if (Defaults == nullptr)
+	{
+		return false;
+	}
+
+	for (UAttributeSet* Set : AbilitySystemComponent->GetSpawnedAttributes())
+	{
+		if (UAuraAttributeSet* AuraAttributeSet = Cast<UAuraAttributeSet>(Set))
+		{
+			AuraAttributeSet->InitAttributesFromDefaults(Defaults->Attributes, Defaults->Values);
+		}
+	}
+	INC_DWORD_STAT(STAT_AuraAttributeDefaultsApplied);
+	return true;
+}
+
+UAuraAttributeDefaultsSubsystem* UAuraAttributeDefaultsSubsystem::Get(const UObject* WorldContext)
+{
+	const UWorld* World = WorldContext ? WorldContext->GetWorld() : nullptr;
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<UAuraAttributeDefaultsSubsystem>() : nullptr;
+}
+
+#if !UE_BUILD_SHIPPING
+/**
+ * @brief 计时基准：给一波敌人写入初始属性，比较表驱动的一次性写入和每个属性应用一个即时GameplayEffect
+ * 用法：Aura.AttributeDefaults.Benchmark [Enemies=敌人数量] [Defaults=行名] [Level=等级]，默认200个敌人、表中第一行、等级1；
+ * 需要在服务器或单机的世界中运行（可以用-nullrhi无头启动）
+ * @note 每个敌人用一个只带能力系统组件和UAuraAttributeSet的空Actor代替；GameplayEffect在计时前创建好，
+ *    只统计应用的开销，相当于每个属性一个初始化效果蓝图的做法
+ */
+static void RunAttributeDefaultsBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+	UAuraAttributeDefaultsSubsystem* DefaultsSubsystem = UAuraAttributeDefaultsSubsystem::Get(World);
+	if (DefaultsSubsystem == nullptr || World->GetNetMode() == NM_Client)
+	{
+		UE_LOG(LogAura, Warning, TEXT("Aura.AttributeDefaults.Benchmark 需要在服务器或单机的游戏世界中运行"));
+		return;
+	}
+
+	int32 NumEnemies = 200;
+	int32 Level = 1;
+	FString DefaultsName;
+	for (const FString& Arg : Args)
+	{
+		FParse::Value(*Arg, TEXT("Enemies="), NumEnemies);
+		FParse::Value(*Arg, TEXT("Level="), Level);
+		FParse::Value(*Arg, TEXT("Defaults="), DefaultsName);
+	}
+	NumEnemies = FMath::Max(NumEnemies, 1);
+	if (DefaultsName.IsEmpty())
+	{
+		if (const UDataTable* Table = DefaultsSubsystem->AttributeDefaultsTable.Get())
+		{
+			const TArray<FName> RowNames = Table->GetRowNames();
+			DefaultsName = RowNames.Num() > 0 ? RowNames[0].ToString() : FString();
+		}
+	}
+	const FAuraBakedAttributeDefaults* Defaults = DefaultsSubsystem->FindDefaults(FName(*DefaultsName), Level);
+	if (Defaults == nullptr || Defaults->Attributes.Num() == 0)
+	{
+		UE_LOG(LogAura, Warning, TEXT("Aura.AttributeDefaults.Benchmark 默认值表中没有行 %s"), *DefaultsName);
+		return;
+	}
+
+	// 每个属性一个即时效果，用Override把属性设为表中的值
+	TArray<UGameplayEffect*> Effects;
+	for (int32 i = 0; i < Defaults->Attributes.Num(); ++i)
+	{
+		UGameplayEffect* Effect = NewObject<UGameplayEffect>(GetTransientPackage());
+		Effect->AddToRoot();
+		Effect->DurationPolicy = EGameplayEffectDurationType::Instant;
+		FGameplayModifierInfo& Modifier = Effect->Modifiers.AddDefaulted_GetRef();
+		Modifier.Attribute = Defaults->Attributes[i];
+		Modifier.ModifierOp = EGameplayModOp::Override;
+		Modifier.ModifierMagnitude = FGameplayEffectModifierMagnitude(FScalableFloat(Defaults->Values[i]));
+		Effects.Add(Effect);
+	}
+
+	TArray<UAbilitySystemComponent*> Components;
+	for (int32 i = 0; i < NumEnemies * 2; ++i)
+	{
+		if (UAbilitySystemComponent* ASC = AuraBenchmarkUtils::SpawnAbilitySystemActor(World))
+		{
+			Components.Add(ASC);
+		}
+	}
+	const int32 NumTable = Components.Num() / 2;
+
+	// 前一半用表驱动写入，后一半每个属性应用一个效果
+	double StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumTable; ++i)
+	{
+		DefaultsSubsystem->ApplyDefaults(Components[i], FName(*DefaultsName), Level);
+	}
+	const double TableTime = FPlatformTime::Seconds() - StartTime;
+
+	StartTime = FPlatformTime::Seconds();
+	for (int32 i = NumTable; i < Components.Num(); ++i)
+	{
+		for (const UGameplayEffect* Effect : Effects)
+		{
+			Components[i]->ApplyGameplayEffectToSelf(Effect, static_cast<float>(Level), Components[i]->MakeEffectContext());
+		}
+	}
+	const double EffectTime = FPlatformTime::Seconds() - StartTime;
+
+	UE_LOG(LogAura, Display, TEXT("Aura.AttributeDefaults.Benchmark %d enemies x %d attributes (%s level %d): table %.3f ms, per-attribute effects %.3f ms (%d applications)"),
+		NumTable, Effects.Num(), *DefaultsName, Level, TableTime * 1000.0, EffectTime * 1000.0, (Components.Num() - NumTable) * Effects.Num());
+
+	for (UAbilitySystemComponent* ASC : Components)
+	{
+		ASC->GetOwner()->Destroy();
+	}
+	for (UGameplayEffect* Effect : Effects)
+	{
+		Effect->RemoveFromRoot();
+		Effect->MarkAsGarbage();
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CCmdAttributeDefaultsBenchmark(
+	TEXT("Aura.AttributeDefaults.Benchmark"),
+	TEXT("比较表驱动写入初始属性和每个属性应用一个即时效果的耗时。参数：[Enemies=N] [Defaults=行名] [Level=N]，默认200个敌人、第一行、等级1"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunAttributeDefaultsBenchmark));
+#endif
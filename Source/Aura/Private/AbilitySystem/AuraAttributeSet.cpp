@@ -2,11 +2,200 @@
 
 
 #include "AbilitySystem/AuraAttributeSet.h"
+#include "AbilitySystem/AuraEnemyAttributeStore.h"
+#include "Aura/Aura.h"
+#include "Character/AuraEnemyCharacter.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetSerialization.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "Game/AuraNetDormancySubsystem.h"
+#include "Player/AuraPlayerState.h"
+#include "TimerManager.h"
+
+namespace AuraPackedVitals
+{
+    //量化精度：数值乘以该倍数后取整，即保留一位小数
+    static constexpr float QuantizeScale = 10.0f;
+
+    static_assert((int32)EAuraVitalIndex::Num == 4, "FAuraPackedVitals数组长度需要和EAuraVitalIndex::Num保持一致");
+
+    static int32 Quantize(float Value)
+    {
+        return FMath::RoundToInt(Value * QuantizeScale);
+    }
+
+    static float Dequantize(int32 Value)
+    {
+        return static_cast<float>(Value) / QuantizeScale;
+    }
+
+    //ZigZag编码：让绝对值小的负数也能用很少的字节表示
+    static uint32 ZigZagEncode(int32 Value)
+    {
+        return (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31);
+    }
+
+    static int32 ZigZagDecode(uint32 Value)
+    {
+        return static_cast<int32>(Value >> 1) ^ -static_cast<int32>(Value & 1);
+    }
+
+    static void SerializeQuantized(FArchive& Ar, int32& Value)
+    {
+        uint32 Encoded = Ar.IsSaving() ? ZigZagEncode(Value) : 0;
+        Ar.SerializeIntPacked(Encoded);
+        if (Ar.IsLoading())
+        {
+            Value = ZigZagDecode(Encoded);
+        }
+    }
+
+    //一个连接上一次发送的量化值，作为下一次增量的比较基准
+    class FDeltaState : public INetDeltaBaseState
+    {
+    public:
+        int32 QuantizedCurrent[4] = {};
+        int32 QuantizedBase[4] = {};
+
+        virtual bool IsStateEqual(INetDeltaBaseState* OtherState) override
+        {
+            const FDeltaState* Other = static_cast<const FDeltaState*>(OtherState);
+            return FMemory::Memcmp(QuantizedCurrent, Other->QuantizedCurrent, sizeof(QuantizedCurrent)) == 0
+                && FMemory::Memcmp(QuantizedBase, Other->QuantizedBase, sizeof(QuantizedBase)) == 0;
+        }
+    };
+
+    //一个属性：变长当前值 + 1位"基础值是否不同" + 可选的变长基础值
+    static void SerializeVital(FArchive& Ar, int32& QuantizedCurrent, int32& QuantizedBase)
+    {
+        SerializeQuantized(Ar, QuantizedCurrent);
+
+        uint8 bSeparateBase = QuantizedBase != QuantizedCurrent ? 1 : 0;
+        Ar.SerializeBits(&bSeparateBase, 1);
+        if (bSeparateBase)
+        {
+            SerializeQuantized(Ar, QuantizedBase);
+        }
+        else if (Ar.IsLoading())
+        {
+            QuantizedBase = QuantizedCurrent;
+        }
+    }
+
+    //把GAS属性映射到打包结构体中的下标，不是生命/魔力属性时返回false
+    static bool TryGetVitalIndex(const FGameplayAttribute& Attribute, EAuraVitalIndex& OutIndex)
+    {
+        if (Attribute == UAuraAttributeSet::GetHealthAttribute()) { OutIndex = EAuraVitalIndex::Health; return true; }
+        if (Attribute == UAuraAttributeSet::GetMaxHealthAttribute()) { OutIndex = EAuraVitalIndex::MaxHealth; return true; }
+        if (Attribute == UAuraAttributeSet::GetManaAttribute()) { OutIndex = EAuraVitalIndex::Mana; return true; }
+        if (Attribute == UAuraAttributeSet::GetMaxManaAttribute()) { OutIndex = EAuraVitalIndex::MaxMana; return true; }
+        return false;
+    }
+}
+
+bool FAuraPackedVitals::SetValue(EAuraVitalIndex Index, float CurrentValue, float BaseValue)
+{
+    const int32 i = (int32)Index;
+    const int32 NewCurrent = AuraPackedVitals::Quantize(CurrentValue);
+    const int32 NewBase = AuraPackedVitals::Quantize(BaseValue);
+    if (QuantizedCurrent[i] == NewCurrent && QuantizedBase[i] == NewBase)
+    {
+        return false;
+    }
+    QuantizedCurrent[i] = NewCurrent;
+    QuantizedBase[i] = NewBase;
+    return true;
+}
+
+float FAuraPackedVitals::GetCurrentValue(EAuraVitalIndex Index) const
+{
+    return AuraPackedVitals::Dequantize(QuantizedCurrent[(int32)Index]);
+}
+
+float FAuraPackedVitals::GetBaseValue(EAuraVitalIndex Index) const
+{
+    return AuraPackedVitals::Dequantize(QuantizedBase[(int32)Index]);
+}
+
+/**
+ * @brief 打包结构体的按连接增量序列化
+ * 格式：4位掩码 + 掩码中每个属性（变长当前值 + 1位"基础值是否不同" + 可选的变长基础值）
+ * 掩码由当前值和该连接上一次发送的值（OldState）比较得出，第一次发送时包含所有属性；
+ * 生命/魔力在大多数时候基础值等于当前值，一个属性通常只需要1~3个字节
+ */
+bool FAuraPackedVitals::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+{
+    // 没有对象引用，GUID相关的调用不需要处理
+    if (DeltaParms.GatherGuidReferences || DeltaParms.MoveGuidToUnmapped || DeltaParms.bUpdateUnmappedObjects)
+    {
+        return true;
+    }
+
+    constexpr int32 NumVitals = (int32)EAuraVitalIndex::Num;
+    if (DeltaParms.Writer)
+    {
+        const AuraPackedVitals::FDeltaState* OldState = static_cast<const AuraPackedVitals::FDeltaState*>(DeltaParms.OldState);
+        uint8 Mask = 0;
+        for (int32 i = 0; i < NumVitals; ++i)
+        {
+            if (OldState == nullptr || OldState->QuantizedCurrent[i] != QuantizedCurrent[i] || OldState->QuantizedBase[i] != QuantizedBase[i])
+            {
+                Mask |= (1 << i);
+            }
+        }
+
+        // 该连接已经有最新的值，不发送
+        if (Mask == 0)
+        {
+            return false;
+        }
+
+        TSharedPtr<AuraPackedVitals::FDeltaState> NewState = MakeShared<AuraPackedVitals::FDeltaState>();
+        FMemory::Memcpy(NewState->QuantizedCurrent, QuantizedCurrent, sizeof(QuantizedCurrent));
+        FMemory::Memcpy(NewState->QuantizedBase, QuantizedBase, sizeof(QuantizedBase));
+        *DeltaParms.NewState = NewState;
+
+        FBitWriter& Writer = *DeltaParms.Writer;
+        Writer.SerializeBits(&Mask, NumVitals);
+        for (int32 i = 0; i < NumVitals; ++i)
+        {
+            if (Mask & (1 << i))
+            {
+                AuraPackedVitals::SerializeVital(Writer, QuantizedCurrent[i], QuantizedBase[i]);
+            }
+        }
+        return true;
+    }
+
+    if (DeltaParms.Reader)
+    {
+        FBitReader& Reader = *DeltaParms.Reader;
+        uint8 Mask = 0;
+        Reader.SerializeBits(&Mask, NumVitals);
+        ReceivedMask = Mask & ((1 << NumVitals) - 1);
+        for (int32 i = 0; i < NumVitals; ++i)
+        {
+            if (WasReceived((EAuraVitalIndex)i))
+            {
+                AuraPackedVitals::SerializeVital(Reader, QuantizedCurrent[i], QuantizedBase[i]);
+            }
+        }
+        return !Reader.IsError();
+    }
+
+    return true;
+}
 
 UAuraAttributeSet::UAuraAttributeSet()
 {
     //这个函数就是通过ATTRIBUTE_ACCESSORS(UAuraAttributeSet, Health);宏生成的
+    //这里只是兜底的默认值，角色配置了AttributeDefaultsName时由UAuraAttributeDefaultsSubsystem按类型和等级覆盖
     InitHealth(50.0f);
     InitMana(10.0f);
     InitMaxMana(50.0f);
@@ -24,22 +213,49 @@ void UAuraAttributeSet::GetLifetimeReplicatedProps(TArray<class FLifetimePropert
     // 调用父类实现，确保父类中声明的可同步属性也能被注册（如GAS内置基础属性，避免遗漏）
     Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
+    // 打包复制模式：四个属性只通过PackedVitals发送，单独的属性关闭复制
+    // 该函数在CDO上调用，bUsePackedVitalReplication读取的是配置文件中的值
+    // 所有属性都使用推送模型（Push Model）：服务器只有在属性被标记为脏时才比较和发送，空闲的属性集几乎没有复制开销
+    // 属性在PostAttributeChange/PostAttributeBaseChange中标记为脏；需要开启net.IsPushModelEnabled，否则退回到每次都比较
+    FDoRepLifetimeParams Params;
+    Params.Condition = COND_None;
+    Params.RepNotifyCondition = REPNOTIFY_Always;
+    Params.bIsPushBased = true;
+
+    // 主属性和次级属性不参与打包复制，两种模式下都单独复制
+    DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, Strength, Params);
+    DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, Intelligence, Params);
+    DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, Resilience, Params);
+    DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, Vigor, Params);
+    DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, Armor, Params);
+
+    if (bUsePackedVitalReplication)
+    {
+        DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, PackedVitals, Params);
+        DISABLE_REPLICATED_PROPERTY(UAuraAttributeSet, Health);
+        DISABLE_REPLICATED_PROPERTY(UAuraAttributeSet, MaxHealth);
+        DISABLE_REPLICATED_PROPERTY(UAuraAttributeSet, Mana);
+        DISABLE_REPLICATED_PROPERTY(UAuraAttributeSet, MaxMana);
+        return;
+    }
+    DISABLE_REPLICATED_PROPERTY(UAuraAttributeSet, PackedVitals);
+
     // 注册Health属性的同步规则：
-    // 1. DOREPLIFETIME_CONDITION_NOTIFY：带同步条件和回调触发策略的注册宏
+    // 1. DOREPLIFETIME_WITH_PARAMS_FAST：按Params注册，等价于带同步条件和回调触发策略的DOREPLIFETIME_CONDITION_NOTIFY，再加上推送模型
     // 2. 模板参数：当前属性集类（UAuraAttributeSet）、要同步的属性（Health）
     // 3. COND_None：同步条件为"无限制"（只要属性变更，服务器就会同步到客户端，不额外过滤）
     // 4. REPNOTIFY_Always：强制触发OnRep_Health回调（无论同步的新值与客户端旧值是否一致，均执行回调）
     // 用途：确保客户端能实时响应生命值变更（如UI刷新、受伤特效），即使值未变也需触发（如特殊逻辑判定）
-    DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, Health, COND_None, REPNOTIFY_Always);
+    DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, Health, Params);
 
     // 注册MaxHealth属性的同步规则（与Health逻辑一致）：
     // 同步条件无限制，强制触发OnRep_MaxHealth回调
     // 用途：最大生命值变更时（如升级、装备加成），客户端需及时刷新UI上限、属性面板等
-    DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, MaxHealth,COND_None, REPNOTIFY_Always);
+    DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, MaxHealth, Params);
     
-    DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, Mana,COND_None, REPNOTIFY_Always);
+    DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, Mana, Params);
     
-    DOREPLIFETIME_CONDITION_NOTIFY(UAuraAttributeSet, MaxMana,COND_None, REPNOTIFY_Always);
+    DOREPLIFETIME_WITH_PARAMS_FAST(UAuraAttributeSet, MaxMana, Params);
 }
 
 /**
@@ -55,6 +271,7 @@ void UAuraAttributeSet::OnRep_Health(const FGameplayAttributeData& OldHealth) co
     // 2. 触发属性变更的全局事件（OnGameplayAttributeChanged），让其他监听该属性的系统（如UI组件、技能系统）响应
     // 3. 自动处理属性的"旧值→新值"切换逻辑，无需手动维护
     GAMEPLAYATTRIBUTE_REPNOTIFY(UAuraAttributeSet, Health, OldHealth);
+    SyncAttributeStore(GetHealthAttribute());
 }
 
 /**
@@ -68,15 +285,487 @@ void UAuraAttributeSet::OnRep_MaxHealth(const FGameplayAttributeData& OldMaxHeal
     // 调用GAS内置宏，触发MaxHealth属性的全局变更通知
     // 后续可由UI系统监听该事件，刷新最大血量显示；或由技能系统调整基于最大血量的效果（如百分比回血技能）
     GAMEPLAYATTRIBUTE_REPNOTIFY(UAuraAttributeSet, MaxHealth, OldMaxHealth);
+    SyncAttributeStore(GetMaxHealthAttribute());
 }
 
 //于上面的一致
 void UAuraAttributeSet::OnRep_Mana(const FGameplayAttributeData& OldMana) const
 {
     GAMEPLAYATTRIBUTE_REPNOTIFY(UAuraAttributeSet, Mana, OldMana);
+    SyncAttributeStore(GetManaAttribute());
 }
 
 void UAuraAttributeSet::OnRep_MaxMana(const FGameplayAttributeData& OldMaxMana) const
 {
     GAMEPLAYATTRIBUTE_REPNOTIFY(UAuraAttributeSet, MaxMana, OldMaxMana);
+    SyncAttributeStore(GetMaxManaAttribute());
+}
+
+void UAuraAttributeSet::OnRep_Strength(const FGameplayAttributeData& OldStrength) const
+{
+    GAMEPLAYATTRIBUTE_REPNOTIFY(UAuraAttributeSet, Strength, OldStrength);
+}
+
+void UAuraAttributeSet::OnRep_Intelligence(const FGameplayAttributeData& OldIntelligence) const
+{
+    GAMEPLAYATTRIBUTE_REPNOTIFY(UAuraAttributeSet, Intelligence, OldIntelligence);
+}
+
+void UAuraAttributeSet::OnRep_Resilience(const FGameplayAttributeData& OldResilience) const
+{
+    GAMEPLAYATTRIBUTE_REPNOTIFY(UAuraAttributeSet, Resilience, OldResilience);
+}
+
+void UAuraAttributeSet::OnRep_Vigor(const FGameplayAttributeData& OldVigor) const
+{
+    GAMEPLAYATTRIBUTE_REPNOTIFY(UAuraAttributeSet, Vigor, OldVigor);
+}
+
+void UAuraAttributeSet::OnRep_Armor(const FGameplayAttributeData& OldArmor) const
+{
+    GAMEPLAYATTRIBUTE_REPNOTIFY(UAuraAttributeSet, Armor, OldArmor);
+}
+
+/**
+ * @brief 属性当前值变化后的回调（GAS在修改属性值后调用）
+ * 服务器在这里把变化的属性标记为脏（推送模型），并通知PlayerState提高网络更新频率
+ * 打包复制模式下，把最新的当前值和基础值量化写入PackedVitals，由属性复制系统负责比较和发送
+ */
+void UAuraAttributeSet::PostAttributeChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue)
+{
+    Super::PostAttributeChange(Attribute, OldValue, NewValue);
+    SyncAttributeStore(Attribute);
+
+    const AActor* OwningActor = GetOwningActor();
+    if (OwningActor == nullptr || !OwningActor->HasAuthority())
+    {
+        return;
+    }
+
+    if (bUsePackedVitalReplication)
+    {
+        EAuraVitalIndex Index;
+        if (AuraPackedVitals::TryGetVitalIndex(Attribute, Index))
+        {
+            const FGameplayAttributeData& Data = GetVitalData(Index);
+            PackedVitals.SetValue(Index, Data.GetCurrentValue(), Data.GetBaseValue());
+        }
+    }
+    MarkAttributeDirty(Attribute);
+}
+
+//基础值变化时当前值不一定变化，但FGameplayAttributeData复制时两个值都会发送，所以也要标记为脏
+void UAuraAttributeSet::PostAttributeBaseChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue) const
+{
+    Super::PostAttributeBaseChange(Attribute, OldValue, NewValue);
+
+    const AActor* OwningActor = GetOwningActor();
+    if (OwningActor && OwningActor->HasAuthority())
+    {
+        MarkAttributeDirty(Attribute);
+    }
+}
+
+/**
+ * @brief 批量写入初始属性
+ * 直接写FGameplayAttributeData，不走GameplayEffect，也不会逐个触发PostAttributeChange；
+ * 所有属性写完后标记脏属性，并只通知一次复制活动
+ * @note 不会广播属性变化委托，初始化之后由WidgetController的BroadcastInitialValues刷新UI
+ */
+void UAuraAttributeSet::InitAttributesFromDefaults(TConstArrayView<FGameplayAttribute> Attributes, TConstArrayView<float> Values)
+{
+    check(Attributes.Num() == Values.Num());
+
+    UAbilitySystemComponent* ASC = GetOwningAbilitySystemComponent();
+    // 已经有激活的效果（例如重新初始化时身上还有无限效果）时当前值由聚合器计算，只能通过ASC设置基础值
+    const bool bHasActiveEffects = ASC && ASC->GetActiveGameplayEffects().GetNumGameplayEffects() > 0;
+    const AActor* OwningActor = GetOwningActor();
+    const bool bAuthority = OwningActor && OwningActor->HasAuthority();
+
+    bool bAnyWritten = false;
+    for (int32 i = 0; i < Attributes.Num(); ++i)
+    {
+        const FGameplayAttribute& Attribute = Attributes[i];
+        if (!Attribute.IsValid() || !GetClass()->IsChildOf(Attribute.GetAttributeSetClass()))
+        {
+            continue;
+        }
+        if (bHasActiveEffects)
+        {
+            // 走ASC会触发PostAttributeChange/PostAttributeBaseChange，脏标记在那里处理
+            ASC->SetNumericAttributeBase(Attribute, Values[i]);
+            continue;
+        }
+
+        FGameplayAttributeData* Data = Attribute.GetGameplayAttributeData(this);
+        if (Data == nullptr)
+        {
+            continue;
+        }
+        Data->SetBaseValue(Values[i]);
+        Data->SetCurrentValue(Values[i]);
+        SyncAttributeStore(Attribute);
+
+        if (bAuthority)
+        {
+            EAuraVitalIndex Index;
+            if (bUsePackedVitalReplication && AuraPackedVitals::TryGetVitalIndex(Attribute, Index))
+            {
+                PackedVitals.SetValue(Index, Values[i], Values[i]);
+            }
+            MarkAttributePropertyDirty(Attribute);
+            bAnyWritten = true;
+        }
+    }
+
+    if (bAnyWritten)
+    {
+        NotifyReplicationActivity();
+    }
+}
+
+void UAuraAttributeSet::MarkAttributeDirty(const FGameplayAttribute& Attribute) const
+{
+    MarkAttributePropertyDirty(Attribute);
+    NotifyReplicationActivity();
+}
+
+void UAuraAttributeSet::MarkAttributePropertyDirty(const FGameplayAttribute& Attribute) const
+{
+    EAuraVitalIndex Index;
+    if (bUsePackedVitalReplication && AuraPackedVitals::TryGetVitalIndex(Attribute, Index))
+    {
+        MARK_PROPERTY_DIRTY_FROM_NAME(UAuraAttributeSet, PackedVitals, this);
+    }
+    else if (Attribute == GetHealthAttribute())
+    {
+        MARK_PROPERTY_DIRTY_FROM_NAME(UAuraAttributeSet, Health, this);
+    }
+    else if (Attribute == GetMaxHealthAttribute())
+    {
+        MARK_PROPERTY_DIRTY_FROM_NAME(UAuraAttributeSet, MaxHealth, this);
+    }
+    else if (Attribute == GetManaAttribute())
+    {
+        MARK_PROPERTY_DIRTY_FROM_NAME(UAuraAttributeSet, Mana, this);
+    }
+    else if (Attribute == GetMaxManaAttribute())
+    {
+        MARK_PROPERTY_DIRTY_FROM_NAME(UAuraAttributeSet, MaxMana, this);
+    }
+    else if (Attribute == GetStrengthAttribute())
+    {
+        MARK_PROPERTY_DIRTY_FROM_NAME(UAuraAttributeSet, Strength, this);
+    }
+    else if (Attribute == GetIntelligenceAttribute())
+    {
+        MARK_PROPERTY_DIRTY_FROM_NAME(UAuraAttributeSet, Intelligence, this);
+    }
+    else if (Attribute == GetResilienceAttribute())
+    {
+        MARK_PROPERTY_DIRTY_FROM_NAME(UAuraAttributeSet, Resilience, this);
+    }
+    else if (Attribute == GetVigorAttribute())
+    {
+        MARK_PROPERTY_DIRTY_FROM_NAME(UAuraAttributeSet, Vigor, this);
+    }
+    else if (Attribute == GetArmorAttribute())
+    {
+        MARK_PROPERTY_DIRTY_FROM_NAME(UAuraAttributeSet, Armor, this);
+    }
+}
+
+void UAuraAttributeSet::NotifyReplicationActivity() const
+{
+    // 玩家的属性集挂在PlayerState上，属性变化时让PlayerState恢复高频更新并立即发送一次
+    // 敌人的属性集挂在敌人自己身上，属性变化时唤醒休眠的敌人
+    if (AAuraPlayerState* AuraPlayerState = Cast<AAuraPlayerState>(GetOwningActor()))
+    {
+        AuraPlayerState->NotifyReplicationActivity();
+    }
+    else
+    {
+        UAuraNetDormancySubsystem::NotifyActorActivity(GetOwningActor());
+    }
+}
+
+/**
+ * @brief 打包数据同步回调：把量化值写回对应的FGameplayAttributeData
+ * 然后对每个被修改过的属性调用GAMEPLAYATTRIBUTE_REPNOTIFY，和单独复制时OnRep_*的行为一致（REPNOTIFY_Always语义）
+ */
+void UAuraAttributeSet::OnRep_PackedVitals()
+{
+    for (int32 i = 0; i < (int32)EAuraVitalIndex::Num; ++i)
+    {
+        const EAuraVitalIndex Index = (EAuraVitalIndex)i;
+        if (!PackedVitals.WasReceived(Index))
+        {
+            continue;
+        }
+
+        FGameplayAttributeData& Data = GetVitalData(Index);
+        const FGameplayAttributeData OldData = Data;
+        Data.SetBaseValue(PackedVitals.GetBaseValue(Index));
+        Data.SetCurrentValue(PackedVitals.GetCurrentValue(Index));
+
+        switch (Index)
+        {
+        case EAuraVitalIndex::Health:
+            GAMEPLAYATTRIBUTE_REPNOTIFY(UAuraAttributeSet, Health, OldData);
+            SyncAttributeStore(GetHealthAttribute());
+            break;
+        case EAuraVitalIndex::MaxHealth:
+            GAMEPLAYATTRIBUTE_REPNOTIFY(UAuraAttributeSet, MaxHealth, OldData);
+            SyncAttributeStore(GetMaxHealthAttribute());
+            break;
+        case EAuraVitalIndex::Mana:
+            GAMEPLAYATTRIBUTE_REPNOTIFY(UAuraAttributeSet, Mana, OldData);
+            SyncAttributeStore(GetManaAttribute());
+            break;
+        case EAuraVitalIndex::MaxMana:
+            GAMEPLAYATTRIBUTE_REPNOTIFY(UAuraAttributeSet, MaxMana, OldData);
+            SyncAttributeStore(GetMaxManaAttribute());
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+FGameplayAttributeData& UAuraAttributeSet::GetVitalData(EAuraVitalIndex Index)
+{
+    switch (Index)
+    {
+    case EAuraVitalIndex::MaxHealth:
+        return MaxHealth;
+    case EAuraVitalIndex::Mana:
+        return Mana;
+    case EAuraVitalIndex::MaxMana:
+        return MaxMana;
+    case EAuraVitalIndex::Health:
+    default:
+        return Health;
+    }
 }
+
+void UAuraAttributeSet::BindAttributeStore(UAuraEnemyAttributeStore* Store)
+{
+    if (Store == nullptr || AttributeStore.Get() == Store)
+    {
+        return;
+    }
+    UnbindAttributeStore();
+    AttributeStore = Store;
+    AttributeStoreId = Store->Register(this);
+}
+
+void UAuraAttributeSet::UnbindAttributeStore()
+{
+    if (UAuraEnemyAttributeStore* Store = AttributeStore.Get())
+    {
+        Store->Unregister(AttributeStoreId);
+    }
+    AttributeStore.Reset();
+    AttributeStoreId = INDEX_NONE;
+}
+
+void UAuraAttributeSet::BeginDestroy()
+{
+    UnbindAttributeStore();
+    Super::BeginDestroy();
+}
+
+void UAuraAttributeSet::SyncAttributeStore(const FGameplayAttribute& Attribute) const
+{
+    if (AttributeStoreId == INDEX_NONE)
+    {
+        return;
+    }
+    EAuraEnemyAttributeColumn Column;
+    UAuraEnemyAttributeStore* Store = AttributeStore.Get();
+    if (Store && UAuraEnemyAttributeStore::ToColumn(Attribute, Column))
+    {
+        Store->SetValue(AttributeStoreId, Column, Attribute.GetNumericValue(this));
+    }
+}
+
+#if !UE_BUILD_SHIPPING
+/**
+ * @brief 无头带宽测试：在服务器上生成一批敌人持续受到伤害，统计服务器的发送字节数
+ * 用法（服务器世界，至少有一个客户端连接，可以用-server -nullrhi和-nullrhi客户端无头运行）：
+ *   Aura.Net.VitalsBandwidthBenchmark [Enemies=100] [Duration=10] [DamageInterval=0.1]
+ * 流程：在第一个客户端的角色周围生成敌人 → 等待初始复制完成 → 统计Duration秒空闲时的发送速率 →
+ * 每DamageInterval秒随机伤害一半敌人，统计Duration秒的发送速率，两者的差就是生命值复制的带宽
+ * 打包模式在配置中切换（类级别开关，运行时无法修改），两种布局各运行一次比较：
+ *   -ini:Game:[/Script/Aura.AuraAttributeSet]:bUsePackedVitalReplication=True
+ */
+namespace AuraVitalsBandwidthBenchmark
+{
+    struct FRun
+    {
+        TWeakObjectPtr<UWorld> World;
+        TArray<TWeakObjectPtr<AAuraEnemyCharacter>> Enemies;
+        FTimerHandle PhaseTimer;
+        FTimerHandle DamageTimer;
+        float Duration = 10.0f;
+        float DamageInterval = 0.1f;
+        uint32 PhaseStartBytes = 0;
+        double PhaseStartTime = 0.0;
+        double IdleBytesPerSecond = 0.0;
+        int32 NumDamageEvents = 0;
+        FRandomStream Random = FRandomStream(1234);
+    };
+
+    static TSharedPtr<FRun> ActiveRun;
+
+    static void Finish()
+    {
+        if (!ActiveRun.IsValid())
+        {
+            return;
+        }
+        if (UWorld* World = ActiveRun->World.Get())
+        {
+            World->GetTimerManager().ClearTimer(ActiveRun->PhaseTimer);
+            World->GetTimerManager().ClearTimer(ActiveRun->DamageTimer);
+        }
+        for (const TWeakObjectPtr<AAuraEnemyCharacter>& Enemy : ActiveRun->Enemies)
+        {
+            if (Enemy.IsValid())
+            {
+                Enemy->Destroy();
+            }
+        }
+        ActiveRun.Reset();
+    }
+
+    //开始一个统计阶段，返回上一个阶段的平均发送速率（字节/秒）
+    static double RestartPhase(UWorld* World)
+    {
+        const UNetDriver* NetDriver = World->GetNetDriver();
+        const double Now = FPlatformTime::Seconds();
+        const double Elapsed = Now - ActiveRun->PhaseStartTime;
+        const double BytesPerSecond = Elapsed > 0.0 ? (NetDriver->OutTotalBytes - ActiveRun->PhaseStartBytes) / Elapsed : 0.0;
+        ActiveRun->PhaseStartBytes = NetDriver->OutTotalBytes;
+        ActiveRun->PhaseStartTime = Now;
+        return BytesPerSecond;
+    }
+
+    //随机伤害一半敌人，生命值耗尽时回满，保证整个阶段都在持续变化
+    static void DamageEnemies()
+    {
+        for (const TWeakObjectPtr<AAuraEnemyCharacter>& Enemy : ActiveRun->Enemies)
+        {
+            UAbilitySystemComponent* ASC = Enemy.IsValid() ? Enemy->GetAbilitySystemComponent() : nullptr;
+            if (ASC == nullptr || ActiveRun->Random.FRand() < 0.5f)
+            {
+                continue;
+            }
+            const float Health = ASC->GetNumericAttributeBase(UAuraAttributeSet::GetHealthAttribute());
+            const float Damage = ActiveRun->Random.FRandRange(1.0f, 10.0f);
+            const float NewHealth = Health - Damage > 0.0f ? Health - Damage : ASC->GetNumericAttribute(UAuraAttributeSet::GetMaxHealthAttribute());
+            ASC->SetNumericAttributeBase(UAuraAttributeSet::GetHealthAttribute(), NewHealth);
+            ++ActiveRun->NumDamageEvents;
+        }
+    }
+
+    static void OnDamagePhaseFinished()
+    {
+        UWorld* World = ActiveRun->World.Get();
+        if (World == nullptr || World->GetNetDriver() == nullptr)
+        {
+            Finish();
+            return;
+        }
+        const double DamageBytesPerSecond = RestartPhase(World);
+        const bool bPacked = GetDefault<UAuraAttributeSet>()->bUsePackedVitalReplication;
+        const int32 NumConnections = FMath::Max(World->GetNetDriver()->ClientConnections.Num(), 1);
+        const int32 NumEnemies = FMath::Max(ActiveRun->Enemies.Num(), 1);
+        const double VitalBytesPerSecond = DamageBytesPerSecond - ActiveRun->IdleBytesPerSecond;
+        UE_LOG(LogAura, Display, TEXT("Aura.Net.VitalsBandwidthBenchmark [%s] %d enemies, %d connections, %d damage events: idle %.0f B/s, damage %.0f B/s, vitals %.0f B/s (%.1f B/s per enemy per connection)"),
+            bPacked ? TEXT("packed") : TEXT("per-attribute"), NumEnemies, NumConnections, ActiveRun->NumDamageEvents,
+            ActiveRun->IdleBytesPerSecond, DamageBytesPerSecond, VitalBytesPerSecond, VitalBytesPerSecond / NumEnemies / NumConnections);
+        Finish();
+    }
+
+    static void OnIdlePhaseFinished()
+    {
+        UWorld* World = ActiveRun->World.Get();
+        if (World == nullptr || World->GetNetDriver() == nullptr)
+        {
+            Finish();
+            return;
+        }
+        ActiveRun->IdleBytesPerSecond = RestartPhase(World);
+        World->GetTimerManager().SetTimer(ActiveRun->DamageTimer, FTimerDelegate::CreateStatic(&DamageEnemies), ActiveRun->DamageInterval, true);
+        World->GetTimerManager().SetTimer(ActiveRun->PhaseTimer, FTimerDelegate::CreateStatic(&OnDamagePhaseFinished), ActiveRun->Duration, false);
+    }
+
+    static void OnWarmupFinished()
+    {
+        UWorld* World = ActiveRun->World.Get();
+        if (World == nullptr || World->GetNetDriver() == nullptr)
+        {
+            Finish();
+            return;
+        }
+        RestartPhase(World);
+        World->GetTimerManager().SetTimer(ActiveRun->PhaseTimer, FTimerDelegate::CreateStatic(&OnIdlePhaseFinished), ActiveRun->Duration, false);
+    }
+
+    static void Start(const TArray<FString>& Args, UWorld* World)
+    {
+        const UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+        if (NetDriver == nullptr || World->GetNetMode() == NM_Client || NetDriver->ClientConnections.Num() == 0)
+        {
+            UE_LOG(LogAura, Warning, TEXT("Aura.Net.VitalsBandwidthBenchmark 需要在有客户端连接的服务器上运行"));
+            return;
+        }
+        Finish();
+
+        int32 NumEnemies = 100;
+        ActiveRun = MakeShared<FRun>();
+        for (const FString& Arg : Args)
+        {
+            FParse::Value(*Arg, TEXT("Enemies="), NumEnemies);
+            FParse::Value(*Arg, TEXT("Duration="), ActiveRun->Duration);
+            FParse::Value(*Arg, TEXT("DamageInterval="), ActiveRun->DamageInterval);
+        }
+        NumEnemies = FMath::Max(NumEnemies, 1);
+        ActiveRun->Duration = FMath::Max(ActiveRun->Duration, 1.0f);
+        ActiveRun->DamageInterval = FMath::Max(ActiveRun->DamageInterval, 0.01f);
+        ActiveRun->World = World;
+
+        // 敌人放在第一个客户端角色附近（全频率复制的距离以内），按网格排开
+        FVector Center = FVector::ZeroVector;
+        const UNetConnection* Connection = NetDriver->ClientConnections[0];
+        if (const APawn* Pawn = Connection->PlayerController ? Connection->PlayerController->GetPawn() : nullptr)
+        {
+            Center = Pawn->GetActorLocation();
+        }
+        const int32 GridSize = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumEnemies)));
+        constexpr float Spacing = 150.0f;
+
+        FActorSpawnParameters SpawnParameters;
+        SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+        SpawnParameters.ObjectFlags |= RF_Transient;
+        for (int32 i = 0; i < NumEnemies; ++i)
+        {
+            const FVector Offset((i % GridSize - GridSize / 2) * Spacing, (i / GridSize - GridSize / 2) * Spacing, 0.0f);
+            if (AAuraEnemyCharacter* Enemy = World->SpawnActor<AAuraEnemyCharacter>(AAuraEnemyCharacter::StaticClass(), Center + Offset, FRotator::ZeroRotator, SpawnParameters))
+            {
+                Enemy->ActivateAbilitySystem();
+                ActiveRun->Enemies.Add(Enemy);
+            }
+        }
+
+        World->GetTimerManager().SetTimer(ActiveRun->PhaseTimer, FTimerDelegate::CreateStatic(&OnWarmupFinished), 2.0f, false);
+        UE_LOG(LogAura, Display, TEXT("Aura.Net.VitalsBandwidthBenchmark: 生成了%d个敌人，约%.0f秒后输出结果"), ActiveRun->Enemies.Num(), 2.0f + ActiveRun->Duration * 2.0f);
+    }
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CCmdVitalsBandwidthBenchmark(
+    TEXT("Aura.Net.VitalsBandwidthBenchmark"),
+    TEXT("生成一批持续受伤的敌人，统计生命/魔力复制的发送带宽。参数：[Enemies=100] [Duration=10] [DamageInterval=0.1]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&AuraVitalsBandwidthBenchmark::Start));
+#endif
@@ -0,0 +1,684 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AbilitySystem/AuraDerivedAttributeSubsystem.h"
+
+#include "AbilitySystemComponent.h"
+#include "AbilitySystem/AuraAttributeSet.h"
+#include "Async/ParallelFor.h"
+#include "Aura/Aura.h"
+#include "Aura/AuraBenchmarkUtils.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameplayEffectTypes.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Derived Attributes Recompute"), STAT_AuraDerivedAttributesRecompute, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Derived Attributes Recomputed"), STAT_AuraDerivedAttributesRecomputed, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Derived Attribute Source Changes"), STAT_AuraDerivedAttributeSourceChanges, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Derived Attribute Entries"), STAT_AuraDerivedAttributeEntries, STATGROUP_Aura);
+DECLARE_CYCLE_STAT(TEXT("Derived Attributes Batch Gather"), STAT_AuraDerivedAttributesBatchGather, STATGROUP_Aura);
+DECLARE_CYCLE_STAT(TEXT("Derived Attributes Batch Evaluate"), STAT_AuraDerivedAttributesBatchEvaluate, STATGROUP_Aura);
+DECLARE_CYCLE_STAT(TEXT("Derived Attributes Batch Commit"), STAT_AuraDerivedAttributesBatchCommit, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Derived Attributes Batch Writes"), STAT_AuraDerivedAttributesBatchWrites, STATGROUP_Aura);
+
+//批量计算时每个工作线程任务处理的组件数量
+static int32 GAuraDerivedAttributeBatchChunkSize = 64;
+static FAutoConsoleVariableRef CVarAuraDerivedAttributeBatchChunkSize(
+	TEXT("Aura.DerivedAttributes.BatchChunkSize"),
+	GAuraDerivedAttributeBatchChunkSize,
+	TEXT("批量重算次级属性时每个任务处理的能力系统组件数量"));
+
+void UAuraDerivedAttributeSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// 规则表很小，直接同步加载
+	if (!DerivedAttributeRules.IsNull())
+	{
+		const UDataTable* RuleTable = DerivedAttributeRules.LoadSynchronous();
+		if (RuleTable && RuleTable->GetRowStruct() != FAuraDerivedAttributeRow::StaticStruct())
+		{
+			UE_LOG(LogAura, Error, TEXT("%s 的行结构不是FAuraDerivedAttributeRow"), *RuleTable->GetPathName());
+			RuleTable = nullptr;
+		}
+		CompileRules(RuleTable);
+	}
+}
+
+void UAuraDerivedAttributeSubsystem::Deinitialize()
+{
+	// 工作线程还在读取规则和快照，先等它结束
+	if (PendingBatchTask.IsValid())
+	{
+		PendingBatchTask.Wait();
+	}
+	PendingBatch.Reset();
+	bBatchRequested = false;
+
+	TArray<UAbilitySystemComponent*> Registered;
+	for (const TPair<TObjectKey<UAbilitySystemComponent>, FEntry>& Pair : Entries)
+	{
+		if (UAbilitySystemComponent* ASC = Pair.Value.AbilitySystemComponent.Get())
+		{
+			Registered.Add(ASC);
+		}
+	}
+	for (UAbilitySystemComponent* ASC : Registered)
+	{
+		UnregisterAbilitySystem(ASC);
+	}
+	Entries.Reset();
+	DirtyEntries.Reset();
+	SET_DWORD_STAT(STAT_AuraDerivedAttributeEntries, 0);
+
+	Super::Deinitialize();
+}
+
+void UAuraDerivedAttributeSubsystem::CompileRules(const UDataTable* RuleTable)
+{
+	Rules.Reset();
+	SourceAttributes.Reset();
+	AffectedRulesBySource.Reset();
+	if (RuleTable == nullptr)
+	{
+		return;
+	}
+
+	TArray<FAuraCompiledDerivedRule> Unsorted;
+	RuleTable->ForeachRow<FAuraDerivedAttributeRow>(TEXT("AuraDerivedAttributes"),
+		[&Unsorted](const FName& RowName, const FAuraDerivedAttributeRow& Row)
+		{
+			if (!Row.Target.IsValid())
+			{
+				return;
+			}
+			FAuraCompiledDerivedRule& Rule = Unsorted.AddDefaulted_GetRef();
+			Rule.Target = Row.Target;
+			Rule.BaseValue = Row.BaseValue;
+			for (const FAuraDerivedAttributeTerm& Term : Row.Terms)
+			{
+				if (Term.Source.IsValid())
+				{
+					Rule.Sources.Add(Term.Source);
+					Rule.Coefficients.Add(Term.Coefficient);
+				}
+			}
+		});
+
+	// 按依赖排序：规则的来源是其他规则的目标时，排在那条规则之后；剩下无法排序的规则有循环依赖
+	TArray<bool> Placed;
+	Placed.Init(false, Unsorted.Num());
+	bool bProgress = true;
+	while (bProgress)
+	{
+		bProgress = false;
+		for (int32 i = 0; i < Unsorted.Num(); ++i)
+		{
+			if (Placed[i])
+			{
+				continue;
+			}
+			bool bReady = true;
+			for (int32 j = 0; j < Unsorted.Num() && bReady; ++j)
+			{
+				bReady = j == i || Placed[j] || !Unsorted[i].Sources.Contains(Unsorted[j].Target);
+			}
+			if (bReady)
+			{
+				Rules.Add(Unsorted[i]);
+				Placed[i] = true;
+				bProgress = true;
+			}
+		}
+	}
+	for (int32 i = 0; i < Unsorted.Num(); ++i)
+	{
+		if (!Placed[i])
+		{
+			UE_LOG(LogAura, Error, TEXT("推导规则 %s 存在循环依赖，已忽略"), *Unsorted[i].Target.GetName());
+		}
+	}
+
+	// 每个来源属性影响的规则：直接使用它的规则，再按依赖顺序把这些规则的下游也加进来
+	for (const FAuraCompiledDerivedRule& Rule : Rules)
+	{
+		for (const FGameplayAttribute& Source : Rule.Sources)
+		{
+			SourceAttributes.AddUnique(Source);
+		}
+	}
+	AffectedRulesBySource.SetNum(SourceAttributes.Num());
+	for (int32 SourceIndex = 0; SourceIndex < SourceAttributes.Num(); ++SourceIndex)
+	{
+		TBitArray<>& Affected = AffectedRulesBySource[SourceIndex];
+		Affected.Init(false, Rules.Num());
+		for (int32 i = 0; i < Rules.Num(); ++i)
+		{
+			if (Rules[i].Sources.Contains(SourceAttributes[SourceIndex]))
+			{
+				Affected[i] = true;
+			}
+		}
+		for (int32 i = 0; i < Rules.Num(); ++i)
+		{
+			if (!Affected[i])
+			{
+				continue;
+			}
+			for (int32 j = i + 1; j < Rules.Num(); ++j)
+			{
+				if (Rules[j].Sources.Contains(Rules[i].Target))
+				{
+					Affected[j] = true;
+				}
+			}
+		}
+	}
+
+	// 批量计算用的下标：所有出现过的属性排成一行，规则通过下标读写
+	BatchAttributes = SourceAttributes;
+	for (FAuraCompiledDerivedRule& Rule : Rules)
+	{
+		Rule.TargetBatchIndex = BatchAttributes.AddUnique(Rule.Target);
+		Rule.TargetSourceIndex = SourceAttributes.IndexOfByKey(Rule.Target);
+		Rule.SourceBatchIndices.Reset(Rule.Sources.Num());
+		for (const FGameplayAttribute& Source : Rule.Sources)
+		{
+			Rule.SourceBatchIndices.Add(BatchAttributes.IndexOfByKey(Source));
+		}
+	}
+	EnemyRuleScales.Init(1.0f, Rules.Num());
+}
+
+void UAuraDerivedAttributeSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// 上一帧启动的批量计算完成后统一写回，然后才能启动下一次
+	if (PendingBatch.IsValid() && PendingBatchTask.IsCompleted())
+	{
+		const TSharedPtr<FBatch> Batch = MoveTemp(PendingBatch);
+		PendingBatchTask = UE::Tasks::FTask();
+		CommitBatch(*Batch);
+	}
+	if (bBatchRequested && !PendingBatch.IsValid())
+	{
+		bBatchRequested = false;
+		LaunchBatch();
+	}
+
+	if (DirtyEntries.Num() == 0)
+	{
+		return;
+	}
+	SCOPE_CYCLE_COUNTER(STAT_AuraDerivedAttributesRecompute);
+
+	// 计算时写回的属性可能让其他系统注册/注销组件，先取出本帧的队列
+	TArray<TObjectKey<UAbilitySystemComponent>> Pending = MoveTemp(DirtyEntries);
+	DirtyEntries.Reset();
+	for (const TObjectKey<UAbilitySystemComponent>& Key : Pending)
+	{
+		FEntry* Entry = Entries.Find(Key);
+		if (Entry == nullptr)
+		{
+			continue;
+		}
+		if (!Entry->AbilitySystemComponent.IsValid())
+		{
+			// 组件已经销毁但没有注销
+			Entries.Remove(Key);
+			continue;
+		}
+		RecomputeEntry(*Entry);
+	}
+}
+
+TStatId UAuraDerivedAttributeSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAuraDerivedAttributeSubsystem, STATGROUP_Tickables);
+}
+
+void UAuraDerivedAttributeSubsystem::RegisterAbilitySystem(UAbilitySystemComponent* AbilitySystemComponent, bool bApplyEnemyScale)
+{
+	if (AbilitySystemComponent == nullptr || Rules.Num() == 0)
+	{
+		return;
+	}
+	const TObjectKey<UAbilitySystemComponent> Key(AbilitySystemComponent);
+	if (Entries.Contains(Key))
+	{
+		return;
+	}
+
+	FEntry& Entry = Entries.Add(Key);
+	Entry.AbilitySystemComponent = AbilitySystemComponent;
+	Entry.bApplyEnemyScale = bApplyEnemyScale;
+	Entry.DirtyRules.Init(false, Rules.Num());
+	for (int32 SourceIndex = 0; SourceIndex < SourceAttributes.Num(); ++SourceIndex)
+	{
+		const FGameplayAttribute& Source = SourceAttributes[SourceIndex];
+		if (AbilitySystemComponent->HasAttributeSetForAttribute(Source))
+		{
+			const FDelegateHandle Handle = AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(Source)
+				.AddUObject(this, &UAuraDerivedAttributeSubsystem::OnSourceAttributeChanged, Key, SourceIndex);
+			Entry.DelegateHandles.Emplace(Source, Handle);
+		}
+	}
+	SET_DWORD_STAT(STAT_AuraDerivedAttributeEntries, Entries.Num());
+
+	MarkAllDirty(AbilitySystemComponent);
+}
+
+void UAuraDerivedAttributeSubsystem::UnregisterAbilitySystem(UAbilitySystemComponent* AbilitySystemComponent)
+{
+	FEntry Entry;
+	if (AbilitySystemComponent == nullptr || !Entries.RemoveAndCopyValue(TObjectKey<UAbilitySystemComponent>(AbilitySystemComponent), Entry))
+	{
+		return;
+	}
+	for (const TPair<FGameplayAttribute, FDelegateHandle>& Pair : Entry.DelegateHandles)
+	{
+		AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(Pair.Key).Remove(Pair.Value);
+	}
+	SET_DWORD_STAT(STAT_AuraDerivedAttributeEntries, Entries.Num());
+}
+
+void UAuraDerivedAttributeSubsystem::MarkAllDirty(UAbilitySystemComponent* AbilitySystemComponent)
+{
+	if (AbilitySystemComponent)
+	{
+		MarkDirty(TObjectKey<UAbilitySystemComponent>(AbilitySystemComponent), TBitArray<>(true, Rules.Num()));
+	}
+}
+
+void UAuraDerivedAttributeSubsystem::RecomputeNow(UAbilitySystemComponent* AbilitySystemComponent)
+{
+	if (FEntry* Entry = AbilitySystemComponent ? Entries.Find(TObjectKey<UAbilitySystemComponent>(AbilitySystemComponent)) : nullptr)
+	{
+		RecomputeEntry(*Entry);
+	}
+}
+
+void UAuraDerivedAttributeSubsystem::OnSourceAttributeChanged(const FOnAttributeChangeData& Data, TObjectKey<UAbilitySystemComponent> Key, int32 SourceIndex)
+{
+	if (bCommitting || !AffectedRulesBySource.IsValidIndex(SourceIndex))
+	{
+		return;
+	}
+	INC_DWORD_STAT(STAT_AuraDerivedAttributeSourceChanges);
+	MarkDirty(Key, AffectedRulesBySource[SourceIndex]);
+}
+
+void UAuraDerivedAttributeSubsystem::MarkDirty(TObjectKey<UAbilitySystemComponent> Key, const TBitArray<>& DirtyRules)
+{
+	FEntry* Entry = Entries.Find(Key);
+	if (Entry == nullptr)
+	{
+		return;
+	}
+	Entry->DirtyRules.CombineWithBitwiseOR(DirtyRules, EBitwiseOperatorFlags::MaintainSize);
+	++Entry->Revision;
+	if (!Entry->bQueued)
+	{
+		Entry->bQueued = true;
+		DirtyEntries.Add(Key);
+	}
+}
+
+void UAuraDerivedAttributeSubsystem::RecomputeEntry(FEntry& Entry)
+{
+	Entry.bQueued = false;
+	UAbilitySystemComponent* ASC = Entry.AbilitySystemComponent.Get();
+	if (ASC == nullptr)
+	{
+		return;
+	}
+
+	// 按依赖顺序计算，上游规则写回的结果在下游规则读取时已经是最新值
+	TGuardValue<bool> CommitGuard(bCommitting, true);
+	for (TConstSetBitIterator<> It(Entry.DirtyRules); It; ++It)
+	{
+		const FAuraCompiledDerivedRule& Rule = Rules[It.GetIndex()];
+		if (!ASC->HasAttributeSetForAttribute(Rule.Target))
+		{
+			continue;
+		}
+		float Value = Rule.BaseValue;
+		for (int32 i = 0; i < Rule.Sources.Num(); ++i)
+		{
+			Value += Rule.Coefficients[i] * ASC->GetNumericAttribute(Rule.Sources[i]);
+		}
+		Value *= GetRuleScale(Entry, It.GetIndex());
+		if (!FMath::IsNearlyEqual(ASC->GetNumericAttributeBase(Rule.Target), Value))
+		{
+			ASC->SetNumericAttributeBase(Rule.Target, Value);
+		}
+		INC_DWORD_STAT(STAT_AuraDerivedAttributesRecomputed);
+	}
+	Entry.DirtyRules.Init(false, Rules.Num());
+}
+
+bool UAuraDerivedAttributeSubsystem::SetEnemyAttributeScale(const FGameplayAttribute& Target, float Scale)
+{
+	bool bFound = false;
+	for (int32 RuleIndex = 0; RuleIndex < Rules.Num(); ++RuleIndex)
+	{
+		if (Rules[RuleIndex].Target == Target)
+		{
+			EnemyRuleScales[RuleIndex] = Scale;
+			bFound = true;
+		}
+	}
+	if (bFound)
+	{
+		RequestBatchRecompute();
+	}
+	return bFound;
+}
+
+void UAuraDerivedAttributeSubsystem::RequestBatchRecompute()
+{
+	// 同一帧内的多次请求合并为一次；正在计算时等这一批写回后再启动
+	bBatchRequested = true;
+}
+
+/**
+ * @brief 抓取输入快照并启动异步计算
+ * 游戏线程只读取每个组件的当前值和目标属性的基础值，计算全部在工作线程上完成，
+ * 下一帧（或之后任务完成的那一帧）在Tick中写回，游戏线程不需要等待
+ */
+void UAuraDerivedAttributeSubsystem::LaunchBatch()
+{
+	if (Rules.Num() == 0 || Entries.Num() == 0)
+	{
+		return;
+	}
+	SCOPE_CYCLE_COUNTER(STAT_AuraDerivedAttributesBatchGather);
+
+	const int32 NumRules = Rules.Num();
+	const TSharedPtr<FBatch> Batch = MakeShared<FBatch>();
+	Batch->Keys.Reserve(Entries.Num());
+	Batch->Revisions.Reserve(Entries.Num());
+	Batch->Values.Reserve(Entries.Num() * BatchAttributes.Num());
+	Batch->OldBases.Reserve(Entries.Num() * NumRules);
+	Batch->TargetValid.Reserve(Entries.Num() * NumRules);
+	Batch->Scales.Reserve(Entries.Num() * NumRules);
+	for (const TPair<TObjectKey<UAbilitySystemComponent>, FEntry>& Pair : Entries)
+	{
+		const UAbilitySystemComponent* ASC = Pair.Value.AbilitySystemComponent.Get();
+		if (ASC == nullptr)
+		{
+			continue;
+		}
+		Batch->Keys.Add(Pair.Key);
+		Batch->Revisions.Add(Pair.Value.Revision);
+		for (const FGameplayAttribute& Attribute : BatchAttributes)
+		{
+			Batch->Values.Add(ASC->HasAttributeSetForAttribute(Attribute) ? ASC->GetNumericAttribute(Attribute) : 0.0f);
+		}
+		for (int32 RuleIndex = 0; RuleIndex < NumRules; ++RuleIndex)
+		{
+			const bool bHasTarget = ASC->HasAttributeSetForAttribute(Rules[RuleIndex].Target);
+			Batch->TargetValid.Add(bHasTarget ? 1 : 0);
+			Batch->OldBases.Add(bHasTarget ? ASC->GetNumericAttributeBase(Rules[RuleIndex].Target) : 0.0f);
+			Batch->Scales.Add(GetRuleScale(Pair.Value, RuleIndex));
+		}
+	}
+	if (Batch->Keys.Num() == 0)
+	{
+		return;
+	}
+	Batch->NewBases.SetNumZeroed(Batch->OldBases.Num());
+	Batch->EstimatedCurrents.SetNumZeroed(Batch->OldBases.Num());
+
+	// 规则在Initialize之后不再修改，Deinitialize会等待任务结束，所以任务可以直接读取this上的规则
+	const int32 ChunkSize = FMath::Max(GAuraDerivedAttributeBatchChunkSize, 1);
+	PendingBatch = Batch;
+	PendingBatchTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [this, Batch, ChunkSize]()
+	{
+		SCOPE_CYCLE_COUNTER(STAT_AuraDerivedAttributesBatchEvaluate);
+		const int32 NumEntries = Batch->Keys.Num();
+		const int32 NumChunks = FMath::DivideAndRoundUp(NumEntries, ChunkSize);
+		ParallelFor(NumChunks, [this, &Batch, ChunkSize, NumEntries](int32 ChunkIndex)
+		{
+			const int32 Begin = ChunkIndex * ChunkSize;
+			EvaluateBatchRange(*Batch, Begin, FMath::Min(Begin + ChunkSize, NumEntries));
+		});
+	});
+}
+
+//每个组件的行互不重叠，不同任务之间不需要同步
+void UAuraDerivedAttributeSubsystem::EvaluateBatchRange(FBatch& Batch, int32 Begin, int32 End) const
+{
+	const int32 NumAttributes = BatchAttributes.Num();
+	const int32 NumRules = Rules.Num();
+	TArray<float, TInlineAllocator<32>> Values;
+	for (int32 EntryIndex = Begin; EntryIndex < End; ++EntryIndex)
+	{
+		Values.Reset();
+		Values.Append(Batch.Values.GetData() + EntryIndex * NumAttributes, NumAttributes);
+
+		for (int32 RuleIndex = 0; RuleIndex < NumRules; ++RuleIndex)
+		{
+			const int32 Row = EntryIndex * NumRules + RuleIndex;
+			if (!Batch.TargetValid[Row])
+			{
+				continue;
+			}
+			const FAuraCompiledDerivedRule& Rule = Rules[RuleIndex];
+			float Value = Rule.BaseValue;
+			for (int32 i = 0; i < Rule.SourceBatchIndices.Num(); ++i)
+			{
+				Value += Rule.Coefficients[i] * Values[Rule.SourceBatchIndices[i]];
+			}
+			Value *= Batch.Scales[Row];
+
+			// 目标的新当前值按"修改器都是加法"估计（旧当前值 + 基础值的变化），下游规则读取这个估计值
+			Values[Rule.TargetBatchIndex] += Value - Batch.OldBases[Row];
+			Batch.NewBases[Row] = Value;
+			Batch.EstimatedCurrents[Row] = Values[Rule.TargetBatchIndex];
+		}
+	}
+}
+
+/**
+ * @brief 在游戏线程上一次性写回批量结果
+ * 通过ASC设置基础值：聚合器重新计算当前值，属性变化委托照常广播，推送模型标记脏属性，客户端照常触发RepNotify
+ */
+void UAuraDerivedAttributeSubsystem::CommitBatch(const FBatch& Batch)
+{
+	SCOPE_CYCLE_COUNTER(STAT_AuraDerivedAttributesBatchCommit);
+
+	const int32 NumRules = Rules.Num();
+	int32 NumWrites = 0;
+	for (int32 EntryIndex = 0; EntryIndex < Batch.Keys.Num(); ++EntryIndex)
+	{
+		const TObjectKey<UAbilitySystemComponent>& Key = Batch.Keys[EntryIndex];
+		const FEntry* Entry = Entries.Find(Key);
+		UAbilitySystemComponent* ASC = Entry ? Entry->AbilitySystemComponent.Get() : nullptr;
+		if (ASC == nullptr)
+		{
+			continue;
+		}
+		// 快照之后又被标记为脏的组件交给逐帧路径，用最新的输入计算
+		// 逐帧路径只计算脏规则，这批要写回的（例如缩放变化的）规则不一定在其中，所以把所有规则标记为脏
+		if (Entry->Revision != Batch.Revisions[EntryIndex])
+		{
+			MarkAllDirty(ASC);
+			continue;
+		}
+
+		{
+			TGuardValue<bool> CommitGuard(bCommitting, true);
+			for (int32 RuleIndex = 0; RuleIndex < NumRules; ++RuleIndex)
+			{
+				const int32 Row = EntryIndex * NumRules + RuleIndex;
+				const FGameplayAttribute& Target = Rules[RuleIndex].Target;
+				if (Batch.TargetValid[Row] && !FMath::IsNearlyEqual(ASC->GetNumericAttributeBase(Target), Batch.NewBases[Row]))
+				{
+					ASC->SetNumericAttributeBase(Target, Batch.NewBases[Row]);
+					++NumWrites;
+				}
+			}
+		}
+
+		// 中间属性上有乘法修改器时估计值不准，依赖它的规则标记为脏，由逐帧路径用实际值重新计算
+		for (int32 RuleIndex = 0; RuleIndex < NumRules; ++RuleIndex)
+		{
+			const int32 Row = EntryIndex * NumRules + RuleIndex;
+			const FAuraCompiledDerivedRule& Rule = Rules[RuleIndex];
+			if (Batch.TargetValid[Row] && Rule.TargetSourceIndex != INDEX_NONE
+				&& !FMath::IsNearlyEqual(ASC->GetNumericAttribute(Rule.Target), Batch.EstimatedCurrents[Row]))
+			{
+				MarkDirty(Key, AffectedRulesBySource[Rule.TargetSourceIndex]);
+			}
+		}
+	}
+	INC_DWORD_STAT_BY(STAT_AuraDerivedAttributesBatchWrites, NumWrites);
+}
+
+//Aura.DerivedAttributes.EnemyScale <属性名> <缩放>：例如 Aura.DerivedAttributes.EnemyScale MaxHealth 1.5
+static FAutoConsoleCommandWithWorldAndArgs CCmdAuraDerivedAttributesEnemyScale(
+	TEXT("Aura.DerivedAttributes.EnemyScale"),
+	TEXT("设置敌人次级属性推导结果的缩放（难度），并批量重算所有敌人。参数：<UAuraAttributeSet中的属性名> <缩放>"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UAuraDerivedAttributeSubsystem* DerivedSubsystem = World ? World->GetSubsystem<UAuraDerivedAttributeSubsystem>() : nullptr;
+		if (DerivedSubsystem == nullptr || Args.Num() < 2)
+		{
+			return;
+		}
+		FProperty* Property = FindFProperty<FProperty>(UAuraAttributeSet::StaticClass(), *Args[0]);
+		if (Property == nullptr || !DerivedSubsystem->SetEnemyAttributeScale(FGameplayAttribute(Property), FCString::Atof(*Args[1])))
+		{
+			UE_LOG(LogAura, Warning, TEXT("%s 不是任何推导规则的目标属性"), *Args[0]);
+		}
+	}));
+
+#if !UE_BUILD_SHIPPING
+/**
+ * @brief 计时基准：全局缩放变化时重算所有敌人次级属性的开销
+ * 批量路径分别统计游戏线程抓取快照、工作线程计算（墙钟时间，游戏线程不等待）、游戏线程写回的耗时，
+ * 并和逐个组件在游戏线程上同步重算（RecomputeNow）对比；一帧里游戏线程的停顿是抓取 + 写回，计算和写回分在不同帧
+ * 用法：Aura.DerivedAttributes.BatchBenchmark [敌人数量...] [Iterations=迭代次数]，默认5000个敌人迭代5次；
+ * 需要在服务器或单机的世界中运行（可以用-nullrhi无头启动），规则表必须已经配置
+ * @note 每个敌人用一个只带能力系统组件和UAuraAttributeSet的空Actor代替，不包含角色其他部分的开销；
+ *    世界中已经注册的组件也会参与批量计算，建议在空地图中运行
+ */
+struct FAuraDerivedAttributeBatchBenchmark
+{
+	static void Run(const TArray<FString>& Args, UWorld* World)
+	{
+		UAuraDerivedAttributeSubsystem* Subsystem = World ? World->GetSubsystem<UAuraDerivedAttributeSubsystem>() : nullptr;
+		if (Subsystem == nullptr || World->GetNetMode() == NM_Client)
+		{
+			UE_LOG(LogAura, Warning, TEXT("Aura.DerivedAttributes.BatchBenchmark 需要在服务器或单机的游戏世界中运行"));
+			return;
+		}
+		if (Subsystem->Rules.Num() == 0)
+		{
+			UE_LOG(LogAura, Warning, TEXT("Aura.DerivedAttributes.BatchBenchmark 没有加载推导规则表"));
+			return;
+		}
+		if (Subsystem->IsBatchRecomputeInFlight())
+		{
+			UE_LOG(LogAura, Warning, TEXT("Aura.DerivedAttributes.BatchBenchmark 已经有批量重算在进行，稍后再试"));
+			return;
+		}
+
+		static const int32 DefaultCounts[] = { 5000 };
+		TArray<int32> Counts;
+		int32 Iterations = 5;
+		AuraBenchmarkUtils::ParseCounts(Args, DefaultCounts, Counts, TEXT("Iterations="), Iterations);
+
+		const TArray<float> OriginalScales = Subsystem->EnemyRuleScales;
+		FRandomStream Random(1234);
+		for (const int32 Count : Counts)
+		{
+			TArray<UAbilitySystemComponent*> Components;
+			Components.Reserve(Count);
+			for (int32 i = 0; i < Count; ++i)
+			{
+				UAbilitySystemComponent* ASC = AuraBenchmarkUtils::SpawnAbilitySystemActor(World);
+				if (ASC == nullptr)
+				{
+					continue;
+				}
+				for (const FGameplayAttribute& Source : Subsystem->SourceAttributes)
+				{
+					ASC->SetNumericAttributeBase(Source, Random.FRandRange(5.0f, 20.0f));
+				}
+				Subsystem->RegisterAbilitySystem(ASC, true);
+				Subsystem->RecomputeNow(ASC);
+				Components.Add(ASC);
+			}
+
+			double GatherTime = 0.0;
+			double EvaluateTime = 0.0;
+			double CommitTime = 0.0;
+			double SerialTime = 0.0;
+			int32 BatchRows = 0;
+			for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+			{
+				// 每次迭代切换缩放，保证所有目标属性都真的要写回
+				for (float& Scale : Subsystem->EnemyRuleScales)
+				{
+					Scale = Iteration % 2 == 0 ? 1.1f : 1.0f;
+				}
+
+				double StartTime = FPlatformTime::Seconds();
+				Subsystem->LaunchBatch();
+				GatherTime += FPlatformTime::Seconds() - StartTime;
+				if (!Subsystem->PendingBatch.IsValid())
+				{
+					break;
+				}
+
+				StartTime = FPlatformTime::Seconds();
+				Subsystem->PendingBatchTask.Wait();
+				EvaluateTime += FPlatformTime::Seconds() - StartTime;
+
+				const TSharedPtr<UAuraDerivedAttributeSubsystem::FBatch> Batch = MoveTemp(Subsystem->PendingBatch);
+				Subsystem->PendingBatchTask = UE::Tasks::FTask();
+				BatchRows = Batch->Keys.Num();
+				StartTime = FPlatformTime::Seconds();
+				Subsystem->CommitBatch(*Batch);
+				CommitTime += FPlatformTime::Seconds() - StartTime;
+
+				// 同步路径：同样的缩放变化，逐个组件在游戏线程上重算
+				for (float& Scale : Subsystem->EnemyRuleScales)
+				{
+					Scale = Iteration % 2 == 0 ? 1.0f : 1.1f;
+				}
+				for (UAbilitySystemComponent* ASC : Components)
+				{
+					Subsystem->MarkAllDirty(ASC);
+				}
+				StartTime = FPlatformTime::Seconds();
+				for (UAbilitySystemComponent* ASC : Components)
+				{
+					Subsystem->RecomputeNow(ASC);
+				}
+				SerialTime += FPlatformTime::Seconds() - StartTime;
+			}
+
+			UE_LOG(LogAura, Display, TEXT("Aura.DerivedAttributes.BatchBenchmark %d enemies (%d batch rows) x %d: batch gather %.3f ms + commit %.3f ms on the game thread, evaluate %.3f ms on workers; serial recompute %.3f ms"),
+				Components.Num(), BatchRows, Iterations, GatherTime * 1000.0 / Iterations, CommitTime * 1000.0 / Iterations,
+				EvaluateTime * 1000.0 / Iterations, SerialTime * 1000.0 / Iterations);
+
+			for (UAbilitySystemComponent* ASC : Components)
+			{
+				Subsystem->UnregisterAbilitySystem(ASC);
+				ASC->GetOwner()->Destroy();
+			}
+		}
+		Subsystem->EnemyRuleScales = OriginalScales;
+	}
+};
+
+static FAutoConsoleCommandWithWorldAndArgs CCmdAuraDerivedAttributesBatchBenchmark(
+	TEXT("Aura.DerivedAttributes.BatchBenchmark"),
+	TEXT("统计批量重算所有敌人次级属性时游戏线程和工作线程的耗时，并和逐个同步重算对比。参数：[敌人数量...] [Iterations=N]，默认5000个敌人5次"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&FAuraDerivedAttributeBatchBenchmark::Run));
+#endif
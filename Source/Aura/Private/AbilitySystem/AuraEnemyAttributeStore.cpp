@@ -0,0 +1,398 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AbilitySystem/AuraEnemyAttributeStore.h"
+
+#include "AbilitySystemComponent.h"
+#include "AbilitySystem/AuraAttributeSet.h"
+#include "Aura/Aura.h"
+#include "Aura/AuraBenchmarkUtils.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/Package.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Attribute Store Update"), STAT_AuraEnemyAttributeStoreUpdate, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemy Attribute Store Entries"), STAT_AuraEnemyAttributeStoreEntries, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy Attribute Store Commits"), STAT_AuraEnemyAttributeStoreCommits, STATGROUP_Aura);
+
+namespace AuraEnemyAttributeStore
+{
+	static FGameplayAttribute ToAttribute(EAuraEnemyAttributeColumn Column)
+	{
+		switch (Column)
+		{
+		case EAuraEnemyAttributeColumn::Health: return UAuraAttributeSet::GetHealthAttribute();
+		case EAuraEnemyAttributeColumn::MaxHealth: return UAuraAttributeSet::GetMaxHealthAttribute();
+		case EAuraEnemyAttributeColumn::Mana: return UAuraAttributeSet::GetManaAttribute();
+		case EAuraEnemyAttributeColumn::MaxMana: return UAuraAttributeSet::GetMaxManaAttribute();
+		default: return FGameplayAttribute();
+		}
+	}
+}
+
+int32 FAuraEnemyAttributeColumns::Add()
+{
+	int32 Index = INDEX_NONE;
+	for (TArray<float>& Column : Columns)
+	{
+		Index = Column.Add(0.0f);
+	}
+	return Index;
+}
+
+void FAuraEnemyAttributeColumns::RemoveAtSwap(int32 Index)
+{
+	for (TArray<float>& Column : Columns)
+	{
+		Column.RemoveAtSwap(Index, 1, false);
+	}
+}
+
+void FAuraEnemyAttributeColumns::Reset()
+{
+	for (TArray<float>& Column : Columns)
+	{
+		Column.Reset();
+	}
+}
+
+int32 FAuraEnemyAttributeColumns::ComputeDepleted(TArray<uint8>& OutDepleted) const
+{
+	const int32 Count = Num();
+	OutDepleted.SetNumUninitialized(Count);
+	const float* RESTRICT Health = GetColumn(EAuraEnemyAttributeColumn::Health);
+	uint8* RESTRICT Out = OutDepleted.GetData();
+
+	int32 NumDepleted = 0;
+	for (int32 i = 0; i < Count; ++i)
+	{
+		const uint8 bDepleted = Health[i] <= 0.0f ? 1 : 0;
+		Out[i] = bDepleted;
+		NumDepleted += bDepleted;
+	}
+	return NumDepleted;
+}
+
+void FAuraEnemyAttributeColumns::ComputeRegen(EAuraEnemyAttributeColumn ValueColumn, EAuraEnemyAttributeColumn MaxColumn, float Amount, TArray<float>& OutValues) const
+{
+	const int32 Count = Num();
+	OutValues.SetNumUninitialized(Count);
+	const float* RESTRICT Health = GetColumn(EAuraEnemyAttributeColumn::Health);
+	const float* RESTRICT Value = GetColumn(ValueColumn);
+	const float* RESTRICT Max = GetColumn(MaxColumn);
+	float* RESTRICT Out = OutValues.GetData();
+
+	// 没有分支的循环：先算回复后的值，再按是否存活选择
+	for (int32 i = 0; i < Count; ++i)
+	{
+		const float Regenerated = FMath::Max(Value[i], FMath::Min(Value[i] + Amount, Max[i]));
+		Out[i] = Health[i] > 0.0f ? Regenerated : Value[i];
+	}
+}
+
+void FAuraEnemyAttributeColumns::ComputeHealthFractions(TArray<float>& OutFractions) const
+{
+	const int32 Count = Num();
+	OutFractions.SetNumUninitialized(Count);
+	const float* RESTRICT Health = GetColumn(EAuraEnemyAttributeColumn::Health);
+	const float* RESTRICT MaxHealth = GetColumn(EAuraEnemyAttributeColumn::MaxHealth);
+	float* RESTRICT Out = OutFractions.GetData();
+
+	for (int32 i = 0; i < Count; ++i)
+	{
+		Out[i] = MaxHealth[i] > 0.0f ? FMath::Clamp(Health[i] / MaxHealth[i], 0.0f, 1.0f) : 0.0f;
+	}
+}
+
+void UAuraEnemyAttributeStore::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	SCOPE_CYCLE_COUNTER(STAT_AuraEnemyAttributeStoreUpdate);
+
+	// 属性集被回收但没有注销（例如敌人没有走EndPlay）时清理
+	for (int32 DenseIndex = DenseOwners.Num() - 1; DenseIndex >= 0; --DenseIndex)
+	{
+		if (!DenseOwners[DenseIndex].IsValid())
+		{
+			Unregister(DenseToId[DenseIndex]);
+		}
+	}
+	if (Columns.Num() == 0 || GetWorld()->GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	UpdateDepleted();
+
+	if (HealthRegenPerSecond > 0.0f || ManaRegenPerSecond > 0.0f)
+	{
+		RegenAccumulator += DeltaTime;
+		if (RegenAccumulator >= RegenInterval)
+		{
+			ApplyRegen(RegenAccumulator);
+			RegenAccumulator = 0.0f;
+		}
+	}
+}
+
+TStatId UAuraEnemyAttributeStore::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAuraEnemyAttributeStore, STATGROUP_Tickables);
+}
+
+void UAuraEnemyAttributeStore::Deinitialize()
+{
+	Columns.Reset();
+	DenseOwners.Reset();
+	DenseToId.Reset();
+	DepletedFlags.Reset();
+	IdToDense.Reset();
+	FreeIds.Reset();
+	SET_DWORD_STAT(STAT_AuraEnemyAttributeStoreEntries, 0);
+
+	Super::Deinitialize();
+}
+
+int32 UAuraEnemyAttributeStore::Register(UAuraAttributeSet* AttributeSet)
+{
+	check(AttributeSet);
+
+	const int32 EnemyId = FreeIds.Num() > 0 ? FreeIds.Pop(false) : IdToDense.Add(INDEX_NONE);
+	const int32 DenseIndex = Columns.Add();
+	DenseOwners.Add(AttributeSet);
+	DenseToId.Add(EnemyId);
+	DepletedFlags.Add(0);
+	IdToDense[EnemyId] = DenseIndex;
+
+	for (int32 i = 0; i < (int32)EAuraEnemyAttributeColumn::Num; ++i)
+	{
+		const EAuraEnemyAttributeColumn Column = (EAuraEnemyAttributeColumn)i;
+		Columns.GetColumn(Column)[DenseIndex] = AuraEnemyAttributeStore::ToAttribute(Column).GetNumericValue(AttributeSet);
+	}
+	// 注册时已经没有生命值的敌人不再广播
+	DepletedFlags[DenseIndex] = Columns.GetColumn(EAuraEnemyAttributeColumn::Health)[DenseIndex] <= 0.0f ? 1 : 0;
+
+	SET_DWORD_STAT(STAT_AuraEnemyAttributeStoreEntries, Columns.Num());
+	return EnemyId;
+}
+
+void UAuraEnemyAttributeStore::Unregister(int32 EnemyId)
+{
+	if (!IsValidId(EnemyId))
+	{
+		return;
+	}
+
+	const int32 DenseIndex = IdToDense[EnemyId];
+	const int32 LastIndex = Columns.Num() - 1;
+	Columns.RemoveAtSwap(DenseIndex);
+	DenseOwners.RemoveAtSwap(DenseIndex, 1, false);
+	DenseToId.RemoveAtSwap(DenseIndex, 1, false);
+	DepletedFlags.RemoveAtSwap(DenseIndex, 1, false);
+	if (DenseIndex != LastIndex)
+	{
+		IdToDense[DenseToId[DenseIndex]] = DenseIndex;
+	}
+	IdToDense[EnemyId] = INDEX_NONE;
+	FreeIds.Add(EnemyId);
+
+	SET_DWORD_STAT(STAT_AuraEnemyAttributeStoreEntries, Columns.Num());
+}
+
+void UAuraEnemyAttributeStore::SetValue(int32 EnemyId, EAuraEnemyAttributeColumn Column, float Value)
+{
+	if (IsValidId(EnemyId))
+	{
+		Columns.GetColumn(Column)[IdToDense[EnemyId]] = Value;
+	}
+}
+
+float UAuraEnemyAttributeStore::GetValue(int32 EnemyId, EAuraEnemyAttributeColumn Column) const
+{
+	return IsValidId(EnemyId) ? Columns.GetColumn(Column)[IdToDense[EnemyId]] : 0.0f;
+}
+
+void UAuraEnemyAttributeStore::CollectHealthBars(TArray<FAuraEnemyHealthBar>& OutHealthBars) const
+{
+	OutHealthBars.Reset();
+
+	TArray<float> Fractions;
+	Columns.ComputeHealthFractions(Fractions);
+	for (int32 DenseIndex = 0; DenseIndex < Fractions.Num(); ++DenseIndex)
+	{
+		if (Fractions[DenseIndex] < 1.0f)
+		{
+			if (const UAuraAttributeSet* AttributeSet = DenseOwners[DenseIndex].Get())
+			{
+				OutHealthBars.Add({ AttributeSet->GetOwningActor(), Fractions[DenseIndex] });
+			}
+		}
+	}
+}
+
+bool UAuraEnemyAttributeStore::ToColumn(const FGameplayAttribute& Attribute, EAuraEnemyAttributeColumn& OutColumn)
+{
+	for (int32 i = 0; i < (int32)EAuraEnemyAttributeColumn::Num; ++i)
+	{
+		if (Attribute == AuraEnemyAttributeStore::ToAttribute((EAuraEnemyAttributeColumn)i))
+		{
+			OutColumn = (EAuraEnemyAttributeColumn)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+void UAuraEnemyAttributeStore::UpdateDepleted()
+{
+	if (Columns.ComputeDepleted(DepletedScratch) == 0)
+	{
+		FMemory::Memzero(DepletedFlags.GetData(), DepletedFlags.Num());
+		return;
+	}
+
+	// 先记下刚刚耗尽的敌人，广播时回调可能销毁敌人并修改数组
+	TArray<TWeakObjectPtr<UAuraAttributeSet>, TInlineAllocator<16>> NewlyDepleted;
+	for (int32 DenseIndex = 0; DenseIndex < DepletedScratch.Num(); ++DenseIndex)
+	{
+		if (DepletedScratch[DenseIndex] && !DepletedFlags[DenseIndex])
+		{
+			NewlyDepleted.Add(DenseOwners[DenseIndex]);
+		}
+	}
+	FMemory::Memcpy(DepletedFlags.GetData(), DepletedScratch.GetData(), DepletedFlags.Num());
+
+	for (const TWeakObjectPtr<UAuraAttributeSet>& AttributeSet : NewlyDepleted)
+	{
+		if (AttributeSet.IsValid())
+		{
+			OnEnemyHealthDepleted.Broadcast(AttributeSet->GetOwningActor());
+		}
+	}
+}
+
+void UAuraEnemyAttributeStore::ApplyRegen(float Interval)
+{
+	if (HealthRegenPerSecond > 0.0f)
+	{
+		Columns.ComputeRegen(EAuraEnemyAttributeColumn::Health, EAuraEnemyAttributeColumn::MaxHealth, HealthRegenPerSecond * Interval, RegenScratch);
+		CommitColumn(EAuraEnemyAttributeColumn::Health, RegenScratch);
+	}
+	if (ManaRegenPerSecond > 0.0f)
+	{
+		Columns.ComputeRegen(EAuraEnemyAttributeColumn::Mana, EAuraEnemyAttributeColumn::MaxMana, ManaRegenPerSecond * Interval, RegenScratch);
+		CommitColumn(EAuraEnemyAttributeColumn::Mana, RegenScratch);
+	}
+}
+
+void UAuraEnemyAttributeStore::CommitColumn(EAuraEnemyAttributeColumn Column, const TArray<float>& NewValues)
+{
+	// 写回时属性集会把新值再写入仓库，先收集需要写回的敌人和当前值的变化量，避免一边遍历一边修改
+	TArray<TPair<TWeakObjectPtr<UAuraAttributeSet>, float>> Changes;
+	const float* OldValues = Columns.GetColumn(Column);
+	for (int32 DenseIndex = 0; DenseIndex < NewValues.Num(); ++DenseIndex)
+	{
+		if (NewValues[DenseIndex] != OldValues[DenseIndex])
+		{
+			Changes.Emplace(DenseOwners[DenseIndex], NewValues[DenseIndex] - OldValues[DenseIndex]);
+		}
+	}
+
+	const FGameplayAttribute Attribute = AuraEnemyAttributeStore::ToAttribute(Column);
+	for (const TPair<TWeakObjectPtr<UAuraAttributeSet>, float>& Change : Changes)
+	{
+		const UAuraAttributeSet* AttributeSet = Change.Key.Get();
+		if (UAbilitySystemComponent* ASC = AttributeSet ? AttributeSet->GetOwningAbilitySystemComponent() : nullptr)
+		{
+			// 列中是当前值（包含修改器），直接写入基础值会让修改器再叠加一次，所以只把变化量加到基础值上
+			ASC->SetNumericAttributeBase(Attribute, ASC->GetNumericAttributeBase(Attribute) + Change.Value);
+		}
+	}
+	INC_DWORD_STAT_BY(STAT_AuraEnemyAttributeStoreCommits, Changes.Num());
+}
+
+#if !UE_BUILD_SHIPPING
+/**
+ * @brief 微基准：比较逐个访问属性集对象和遍历列数组的耗时
+ * 用法：Aura.AttributeStore.Benchmark [敌人数量...] [Iterations=迭代次数]，默认1000和10000个敌人各迭代100次
+ * @note 基准中的属性集是连续创建的，内存比实际游戏中（随敌人在不同时间生成）更集中，对象版本的结果偏乐观
+ */
+static void RunEnemyAttributeStoreBenchmark(const TArray<FString>& Args)
+{
+	static const int32 DefaultCounts[] = { 1000, 10000 };
+	TArray<int32> Counts;
+	int32 Iterations = 100;
+	AuraBenchmarkUtils::ParseCounts(Args, DefaultCounts, Counts, TEXT("Iterations="), Iterations);
+
+	FRandomStream Random(1234);
+	for (const int32 Count : Counts)
+	{
+		TArray<UAuraAttributeSet*> AttributeSets;
+		AttributeSets.Reserve(Count);
+		FAuraEnemyAttributeColumns Columns;
+		for (int32 i = 0; i < Count; ++i)
+		{
+			UAuraAttributeSet* AttributeSet = NewObject<UAuraAttributeSet>(GetTransientPackage());
+			AttributeSet->AddToRoot();
+			AttributeSet->InitMaxHealth(100.0f);
+			AttributeSet->InitHealth(Random.FRandRange(-10.0f, 100.0f));
+			AttributeSet->InitMaxMana(50.0f);
+			AttributeSet->InitMana(Random.FRandRange(0.0f, 50.0f));
+			AttributeSets.Add(AttributeSet);
+
+			const int32 Index = Columns.Add();
+			Columns.GetColumn(EAuraEnemyAttributeColumn::Health)[Index] = AttributeSet->GetHealth();
+			Columns.GetColumn(EAuraEnemyAttributeColumn::MaxHealth)[Index] = AttributeSet->GetMaxHealth();
+			Columns.GetColumn(EAuraEnemyAttributeColumn::Mana)[Index] = AttributeSet->GetMana();
+			Columns.GetColumn(EAuraEnemyAttributeColumn::MaxMana)[Index] = AttributeSet->GetMaxMana();
+		}
+
+		// 对象版本：死亡检查 + 生命回复 + 血条比例
+		TArray<float> Scratch;
+		Scratch.SetNumUninitialized(Count);
+		int32 ObjectChecksum = 0;
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			for (int32 i = 0; i < Count; ++i)
+			{
+				const UAuraAttributeSet* AttributeSet = AttributeSets[i];
+				const float Health = AttributeSet->GetHealth();
+				const float MaxHealth = AttributeSet->GetMaxHealth();
+				ObjectChecksum += Health <= 0.0f ? 1 : 0;
+				Scratch[i] = Health > 0.0f ? FMath::Min(Health + 1.0f, MaxHealth) : Health;
+				Scratch[i] += MaxHealth > 0.0f ? Health / MaxHealth : 0.0f;
+			}
+		}
+		const double ObjectTime = FPlatformTime::Seconds() - StartTime;
+
+		// 列数组版本
+		TArray<uint8> Depleted;
+		TArray<float> Regen;
+		TArray<float> Fractions;
+		int32 ColumnChecksum = 0;
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			ColumnChecksum += Columns.ComputeDepleted(Depleted);
+			Columns.ComputeRegen(EAuraEnemyAttributeColumn::Health, EAuraEnemyAttributeColumn::MaxHealth, 1.0f, Regen);
+			Columns.ComputeHealthFractions(Fractions);
+		}
+		const double ColumnTime = FPlatformTime::Seconds() - StartTime;
+
+		UE_LOG(LogAura, Display, TEXT("Aura.AttributeStore.Benchmark %d enemies x %d: objects %.3f us/sweep, columns %.3f us/sweep (checksum %d/%d)"),
+			Count, Iterations, ObjectTime * 1e6 / Iterations, ColumnTime * 1e6 / Iterations, ObjectChecksum, ColumnChecksum);
+
+		for (UAuraAttributeSet* AttributeSet : AttributeSets)
+		{
+			AttributeSet->RemoveFromRoot();
+			AttributeSet->MarkAsGarbage();
+		}
+	}
+}
+
+static FAutoConsoleCommand CCmdEnemyAttributeStoreBenchmark(
+	TEXT("Aura.AttributeStore.Benchmark"),
+	TEXT("比较逐个访问敌人属性集和遍历属性列的耗时。参数：[敌人数量...] [Iterations=N]，默认1000和10000个敌人各100次"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunEnemyAttributeStoreBenchmark));
+#endif
@@ -5,8 +5,37 @@
 
 
 #include "AbilitySystem/AuraAttributeSet.h"
+#include "Actor/AuraEffectActorPool.h"
+#include "Character/AuraCharacterBase.h"
+#include "Character/AuraEnemyCharacter.h"
+#include "Game/AuraAssetPreloadSubsystem.h"
+#include "Game/AuraNetDormancySubsystem.h"
 #include "AbilitySystemBlueprintLibrary.h"
+#include "AbilitySystemComponent.h"
+#include "AbilitySystemGlobals.h"
+#include "Aura/Aura.h"
+#include "Aura/AuraBenchmarkUtils.h"
 #include "GameplayEffect.h"
+#include "Engine/OverlapResult.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Effect Specs Built"), STAT_AuraEffectSpecsBuilt, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Effect Spec Cache Hits"), STAT_AuraEffectSpecCacheHits, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Area Effect Targets"), STAT_AuraAreaEffectTargets, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Effect Applications Rejected"), STAT_AuraEffectApplicationsRejected, STATGROUP_Aura);
+DECLARE_CYCLE_STAT(TEXT("Area Effect Apply"), STAT_AuraAreaEffectApply, STATGROUP_Aura);
+
+//延迟创建模式下，确定要对敌人施加效果时才创建它的能力系统（取能力系统组件本身不会创建）
+static void ActivateTargetAbilitySystem(AActor* TargetActor)
+{
+	if (AAuraEnemyCharacter* Enemy = Cast<AAuraEnemyCharacter>(TargetActor))
+	{
+		Enemy->ActivateAbilitySystem();
+	}
+}
 
 
 /**
@@ -16,8 +45,9 @@
  */
 AAuraEffectActor::AAuraEffectActor()
 {
- 	// 禁用Actor的Tick更新（该Actor仅响应碰撞事件，无需帧更新，节省性能）
-	PrimaryActorTick.bCanEverTick = false;
+ 	// 默认不Tick（该Actor仅响应碰撞事件，无需帧更新，节省性能），只有开启范围模式时才在BeginPlay中启用
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
 	
 	SetRootComponent(CreateDefaultSubobject<USceneComponent>("SceneRoot"));
 	
@@ -34,15 +64,128 @@ AAuraEffectActor::AAuraEffectActor()
 void AAuraEffectActor::BeginPlay()
 {
 	Super::BeginPlay();
+	
+	RefreshAreaModeTick();
+
+	// 拾取物大部分时间都不变化，交给休眠子系统在安静一段时间后休眠
+	if (HasAuthority())
+	{
+		if (UAuraNetDormancySubsystem* DormancySubsystem = GetWorld()->GetSubsystem<UAuraNetDormancySubsystem>())
+		{
+			DormancySubsystem->RegisterActor(this);
+		}
+	}
+}
+
+void AAuraEffectActor::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	// 关卡中放置的效果Actor在地图加载时就会走到这里，效果类在玩家接触之前异步加载完成
+	RequestEffectClassPreload();
+}
+
+void AAuraEffectActor::RequestEffectClassPreload() const
+{
+	const FSoftObjectPath Paths[] = {
+		InstanceGameplayEffectClass.ToSoftObjectPath(),
+		DurationGameplayEffectClass.ToSoftObjectPath(),
+		InfiniteGameplayEffectClass.ToSoftObjectPath(),
+		AreaGameplayEffectClass.ToSoftObjectPath(),
+	};
+	UAuraAssetPreloadSubsystem::RequestPreloadFor(this, Paths);
+}
+
+void AAuraEffectActor::RefreshAreaModeTick()
+{
+	// 范围模式只在服务器上按固定间隔Tick，效果通过GAS复制到客户端
+	const bool bShouldTick = bEnableAreaMode && HasAuthority();
+	if (bShouldTick)
+	{
+		SetActorTickInterval(AreaApplyInterval);
+	}
+	SetActorTickEnabled(bShouldTick);
+}
+
+void AAuraEffectActor::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+	
+	if (bEnableAreaMode)
+	{
+		ApplyAreaEffect();
+	}
+}
+
+/**
+ * 范围模式的批量施加
+ * 一次球形查询收集范围内的所有ASC（同一个Actor的多个碰撞体只算一次），然后共用同一个缓存的效果规格逐个施加
+ * 相比每个目标各自触发一次蓝图重叠事件再调用ApplyEffectToTarget，省去了大量蓝图到C++的往返
+ */
+FAuraAreaEffectReport AAuraEffectActor::ApplyAreaEffect()
+{
+	SCOPE_CYCLE_COUNTER(STAT_AuraAreaEffectApply);
+	
+	FAuraAreaEffectReport Report;
+	if (AreaGameplayEffectClass.IsNull() || !HasAuthority())
+	{
+		return Report;
+	}
+	
+	const double StartTime = FPlatformTime::Seconds();
+	
+	TArray<FOverlapResult> Overlaps;
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(AuraAreaEffect), false, this);
+	GetWorld()->OverlapMultiByObjectType(Overlaps, GetActorLocation(), FQuat::Identity,
+		FCollisionObjectQueryParams(AreaObjectType), FCollisionShape::MakeSphere(AreaRadius), QueryParams);
+	
+	// 软引用的效果类加载失败时不施加，也不为范围内的敌人创建能力系统
+	const TSubclassOf<UGameplayEffect> EffectClass = UAuraAssetPreloadSubsystem::ResolveClass(AreaGameplayEffectClass);
+	if (EffectClass == nullptr)
+	{
+		return Report;
+	}
+	
+	TArray<UAbilitySystemComponent*, TInlineAllocator<64>> TargetASCs;
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		ActivateTargetAbilitySystem(Overlap.GetActor());
+		if (UAbilitySystemComponent* TargetASC = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(Overlap.GetActor()))
+		{
+			TargetASCs.AddUnique(TargetASC);
+			if (AAuraCharacterBase* TargetCharacter = Cast<AAuraCharacterBase>(Overlap.GetActor()))
+			{
+				TargetCharacter->MarkInCombat();
+			}
+			UAuraNetDormancySubsystem::NotifyActorActivity(Overlap.GetActor());
+		}
+	}
+	
+	// 可以共用的效果每个目标拿到的是同一个缓存规格，只有读取来源的效果才逐个创建
+	for (UAbilitySystemComponent* TargetASC : TargetASCs)
+	{
+		const FGameplayEffectSpecHandle EffectSpecHandle = MakeEffectSpec(EffectClass, TargetASC);
+		if (const FGameplayEffectSpec* EffectSpec = EffectSpecHandle.Data.Get())
+		{
+			TargetASC->ApplyGameplayEffectSpecToSelf(*EffectSpec);
+		}
+	}
+	
+	Report.NumTargets = TargetASCs.Num();
+	Report.CostMilliseconds = static_cast<float>((FPlatformTime::Seconds() - StartTime) * 1000.0);
+	INC_DWORD_STAT_BY(STAT_AuraAreaEffectTargets, Report.NumTargets);
+	
+	LastAreaEffectReport = Report;
+	return Report;
 }
 
 /**
  * 给目标Actor应用指定的GameplayEffect（游戏效果）
  * @param Target 要施加游戏效果的目标Actor（如玩家角色、敌人）
- * @param GamePlayEffectClass 要应用的游戏效果类模板（需继承自UGameplayEffect，如血量加成、减速效果蓝图类）
+ * @param GamePlayEffectClass 要应用的游戏效果类模板（软引用，需继承自UGameplayEffect，如血量加成、减速效果蓝图类）
  * 核心逻辑：通过GAS框架给目标的ASC（能力系统组件）施加效果，依赖句柄管理GAS核心对象的生命周期与安全访问
  */
-void AAuraEffectActor::ApplyEffectToTarget(AActor* TargetActor, TSubclassOf<UGameplayEffect> GamePlayEffectClass)
+FActiveGameplayEffectHandle AAuraEffectActor::ApplyEffectToTarget(AActor* TargetActor, TSoftClassPtr<UGameplayEffect> GamePlayEffectClass)
 {
 	/********************************************************************
 	【备选获取ASC的方式】通过接口判断Actor是否包含能力系统组件：
@@ -55,59 +198,397 @@ void AAuraEffectActor::ApplyEffectToTarget(AActor* TargetActor, TSubclassOf<UGam
 	
 	// 1. 通过GAS蓝图库获取目标Actor的AbilitySystemComponent（ASC）——GAS核心组件，所有效果/技能都通过它管理
 	// ASC是连接Actor和GAS框架的桥梁，只有获取到有效ASC，才能施加游戏效果
+	// 延迟创建模式下的敌人此时才创建能力系统
+	ActivateTargetAbilitySystem(TargetActor);
 	UAbilitySystemComponent* TargetASC = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(TargetActor);
 	// 判空：若目标无ASC（如场景静态Actor），直接返回，避免后续非法访问
-	if (TargetASC == nullptr) return;
+	if (TargetASC == nullptr) return FActiveGameplayEffectHandle();
+	
+	// 受到效果的角色进入战斗状态，重要性子系统会提高它的更新频率
+	if (AAuraCharacterBase* TargetCharacter = Cast<AAuraCharacterBase>(TargetActor))
+	{
+		TargetCharacter->MarkInCombat();
+	}
+	// 施加效果前唤醒休眠的目标，效果、属性变化和GameplayCue才能复制到客户端
+	UAuraNetDormancySubsystem::NotifyActorActivity(TargetActor);
 	
-	// 2. 强制检查：确保传入的游戏效果类模板非空（若为空，后续创建效果规格会崩溃）
+	// 2. 取得软引用的效果类（正常情况下已经预加载完成，否则同步加载并输出警告）
+	// 强制检查：确保传入的游戏效果类模板非空（若为空，后续创建效果规格会崩溃）
 	// check断言在Debug模式下触发，提示开发者配置效果类，Release模式下等价于空检查
-	check(GamePlayEffectClass);
+	const TSubclassOf<UGameplayEffect> EffectClass = UAuraAssetPreloadSubsystem::ResolveClass(GamePlayEffectClass);
+	check(EffectClass);
 	
-	// 3. 创建游戏效果上下文句柄（FGameplayEffectContextHandle）
+	// 3. 取得游戏效果规格句柄（FGameplayEffectSpecHandle）
 	// 【句柄核心作用】：
-	// - 管理FGameplayEffectContext（游戏效果上下文）的生命周期，避免悬空指针；
-	// - 存储效果的元数据（发起者、目标、触发场景、效果归因等），是GAS效果的“上下文标签”；
-	// - 句柄是UE对UObject/结构体的安全封装，自动处理内存释放，比直接操作上下文对象更安全
-	FGameplayEffectContextHandle EffectContextHandle = TargetASC->MakeEffectContext();
+	// - 管理FGameplayEffectSpec（游戏效果规格）的生命周期，安全访问规格对象；
+	// - 存储效果的核心配置：效果类、效果等级（EffectLevel）、上下文（发起者、源对象等）；
+	// - 不读取来源的效果和目标无关，同一个效果类和等级只创建一次，所有目标共用，避免每次重叠都分配新的规格和上下文
+	const FGameplayEffectSpecHandle EffectSpecHandle = MakeEffectSpec(EffectClass, TargetASC);
+	
+	// 4. 将效果规格应用到目标自身（ApplyGameplayEffectSpecToSelf）
+	// ASC内部会拷贝一份规格再捕获目标属性、计算数值，缓存的规格本身不会被修改
+	// 返回值是激活效果的句柄，持续/无限效果需要保存它才能在之后移除
+	return TargetASC->ApplyGameplayEffectSpecToSelf(*EffectSpecHandle.Data.Get());
+}
+
+/**
+ * 效果规格能否在所有目标之间共用
+ * 共用的规格没有来源ASC（上下文里的发起者是本EffectActor），捕获不到来源的属性和标签，
+ * 所以效果中只要有来源属性捕获、修改器的来源标签要求、自定义MMC或执行计算（可能读取发起者），就不能共用
+ */
+static bool CanShareEffectSpec(const UGameplayEffect* GameplayEffect)
+{
+	TArray<FGameplayEffectAttributeCaptureDefinition> CaptureDefinitions;
+	GameplayEffect->GetAttributeCaptureDefinitions(CaptureDefinitions);
+	for (const FGameplayEffectAttributeCaptureDefinition& CaptureDefinition : CaptureDefinitions)
+	{
+		if (CaptureDefinition.AttributeSource == EGameplayEffectAttributeCaptureSource::Source)
+		{
+			return false;
+		}
+	}
+	for (const FGameplayModifierInfo& Modifier : GameplayEffect->Modifiers)
+	{
+		if (!Modifier.SourceTags.IsEmpty() || Modifier.ModifierMagnitude.GetCustomMagnitudeCalculationClass() != nullptr)
+		{
+			return false;
+		}
+	}
+	return GameplayEffect->Executions.Num() == 0;
+}
+
+FGameplayEffectSpecHandle AAuraEffectActor::MakeEffectSpec(TSubclassOf<UGameplayEffect> GamePlayEffectClass, UAbilitySystemComponent* TargetASC)
+{
+	if (GamePlayEffectClass == nullptr || TargetASC == nullptr)
+	{
+		return FGameplayEffectSpecHandle();
+	}
 	
-	// 4. 给上下文设置“源对象”（当前EffectActor）——标记效果的发起者，便于后续追溯效果来源（如哪个机关触发了加血）
+	const FGameplayEffectSpecHandle& CachedSpecHandle = GetOrCreateEffectSpec(GamePlayEffectClass);
+	if (CachedSpecHandle.IsValid())
+	{
+		return CachedSpecHandle;
+	}
+	
+	// 读取来源的效果和原来一样每次创建：上下文由目标ASC创建（来源即目标），源对象是本EffectActor
+	FGameplayEffectContextHandle EffectContextHandle = TargetASC->MakeEffectContext();
 	EffectContextHandle.AddSourceObject(this);
+	return TargetASC->MakeOutgoingSpec(GamePlayEffectClass, EffectLevel, EffectContextHandle);
+}
+
+const FGameplayEffectSpecHandle& AAuraEffectActor::GetOrCreateEffectSpec(TSubclassOf<UGameplayEffect> GamePlayEffectClass)
+{
+	// 效果类没有配置、加载失败或者不能共用时返回空句柄，调用方需要检查IsValid
+	static const FGameplayEffectSpecHandle EmptySpecHandle;
+	if (GamePlayEffectClass == nullptr || UnsharedEffectClasses.Contains(GamePlayEffectClass))
+	{
+		return EmptySpecHandle;
+	}
 	
-	// 5. 创建游戏效果规格句柄（FGameplayEffectSpecHandle）
-	// 【句柄核心作用】：
-	// - 管理FGameplayEffectSpec（游戏效果规格）的生命周期，安全访问规格对象；
-	// - 存储效果的核心配置：效果类、效果等级（1.f）、上下文（EffectContextHandle）；
-	// - 是“效果施加”的核心载体，后续可通过该句柄设置效果参数（如血量加成值、减速百分比）
-	FGameplayEffectSpecHandle EffectSpecHandle = TargetASC->MakeOutgoingSpec(GamePlayEffectClass,1.f,EffectContextHandle);
+	const UGameplayEffect* GameplayEffect = GamePlayEffectClass->GetDefaultObject<UGameplayEffect>();
+	if (!CachedEffectSpecs.Contains(GamePlayEffectClass) && !CanShareEffectSpec(GameplayEffect))
+	{
+		UnsharedEffectClasses.Add(GamePlayEffectClass);
+		return EmptySpecHandle;
+	}
 	
-	// 6. 将效果规格应用到目标自身（ApplyGameplayEffectSpecToSelf）
-	// EffectSpecHandle.Data.Get()：通过句柄获取底层的效果规格对象（需确保句柄有效，此处因前面判空+check，可安全访问）
-	TargetASC->ApplyGameplayEffectSpecToSelf(*EffectSpecHandle.Data.Get());
+	FGameplayEffectSpecHandle& SpecHandle = CachedEffectSpecs.FindOrAdd(GamePlayEffectClass);
+	if (SpecHandle.IsValid() && SpecHandle.Data->GetLevel() == EffectLevel)
+	{
+		INC_DWORD_STAT(STAT_AuraEffectSpecCacheHits);
+		return SpecHandle;
+	}
+	
+	INC_DWORD_STAT(STAT_AuraEffectSpecsBuilt);
+	
+	// 创建游戏效果上下文句柄（FGameplayEffectContextHandle）
+	// 存储效果的元数据（发起者、源对象等），规格共享后发起者和源对象都是当前EffectActor
+	FGameplayEffectContextHandle EffectContextHandle(UAbilitySystemGlobals::Get().AllocGameplayEffectContext());
+	EffectContextHandle.AddInstigator(this, this);
+	// 给上下文设置“源对象”（当前EffectActor）——标记效果的发起者，便于后续追溯效果来源（如哪个机关触发了加血）
+	EffectContextHandle.AddSourceObject(this);
+	
+	// 和UAbilitySystemComponent::MakeOutgoingSpec的做法一致，直接用效果类的CDO创建规格
+	SpecHandle = FGameplayEffectSpecHandle(new FGameplayEffectSpec(GameplayEffect, EffectContextHandle, EffectLevel));
+	return SpecHandle;
+}
+
+void AAuraEffectActor::SetEffectLevel(float NewLevel)
+{
+	if (EffectLevel != NewLevel)
+	{
+		EffectLevel = NewLevel;
+		CachedEffectSpecs.Reset();
+	}
 }
 
 void AAuraEffectActor::OnOverlap(AActor* TargetActor)
 {
-	if (InstanceEffectApplycationPolicy == EffectApplycationPolicy::ApplyOnOverlap)
+	if (InstanceEffectApplycationPolicy == EffectApplycationPolicy::ApplyOnOverlap
+		&& CanApplyToTarget(TargetActor, EffectApplycationPolicy::ApplyOnOverlap, InstanceGameplayEffectClass))
 	{
 		ApplyEffectToTarget(TargetActor,InstanceGameplayEffectClass);
 	}
-	if (DurationEffectApplycationPolicy == EffectApplycationPolicy::ApplyOnOverlap)
+	if (DurationEffectApplycationPolicy == EffectApplycationPolicy::ApplyOnOverlap
+		&& CanApplyToTarget(TargetActor, EffectApplycationPolicy::ApplyOnOverlap, DurationGameplayEffectClass))
 	{
 		ApplyEffectToTarget(TargetActor,DurationGameplayEffectClass);
 	}
+	if (InfiniteEffectApplycationPolicy == EffectApplycationPolicy::ApplyOnOverlap)
+	{
+		ApplyInfiniteEffectToTarget(TargetActor);
+	}
 }
 
 void AAuraEffectActor::OnEndOverlap(AActor* TargetActor)
 {
-	if (InstanceEffectApplycationPolicy == EffectApplycationPolicy::ApplyOnEndOverlap)
+	if (InstanceEffectApplycationPolicy == EffectApplycationPolicy::ApplyOnEndOverlap
+		&& CanApplyToTarget(TargetActor, EffectApplycationPolicy::ApplyOnEndOverlap, InstanceGameplayEffectClass))
 	{
 		ApplyEffectToTarget(TargetActor,InstanceGameplayEffectClass);
 	}
-	if (DurationEffectApplycationPolicy == EffectApplycationPolicy::ApplyOnEndOverlap)
+	if (DurationEffectApplycationPolicy == EffectApplycationPolicy::ApplyOnEndOverlap
+		&& CanApplyToTarget(TargetActor, EffectApplycationPolicy::ApplyOnEndOverlap, DurationGameplayEffectClass))
 	{
 		ApplyEffectToTarget(TargetActor,DurationGameplayEffectClass);
 	}
+	
+	//先移除之前重叠时施加的无限效果，再处理结束重叠时施加的无限效果
+	bool bRemovedEffect = false;
+	if (InfinitEffectRemovePolicy == EffectRemovePolicy::RemoveOnEndOverlap)
+	{
+		bRemovedEffect = RemoveInfiniteEffectFromTarget(TargetActor);
+	}
+	if (InfiniteEffectApplycationPolicy == EffectApplycationPolicy::ApplyOnEndOverlap)
+	{
+		ApplyInfiniteEffectToTarget(TargetActor);
+	}
+	
+	//效果被移除后按配置销毁自身（对象池中的Actor会被放回对象池）
+	if (bRemovedEffect && bDestoryOnEffectRemoval)
+	{
+		DestroyEffectActor();
+	}
+}
+
+/**
+ * 冷却和去重判断
+ * 1. 去重：距离同一个目标、同一种事件、同一个效果类的上一次触发不足OverlapDedupWindow秒，视为边界抖动产生的重复事件
+ * 2. 冷却：距离同一个目标、同一种事件、同一个效果类的上一次成功施加不足ReapplyCooldown秒
+ * 两者任一成立都拒绝本次施加，并计入NumRejectedApplications和STAT_AuraEffectApplicationsRejected
+ * 记录按（目标，事件，效果类）区分：例如重叠时施加即时效果之后马上结束重叠，结束重叠时的持续效果不会被当成重复事件
+ */
+bool AAuraEffectActor::CanApplyToTarget(AActor* TargetActor, EffectApplycationPolicy Event, const TSoftClassPtr<UGameplayEffect>& EffectClass)
+{
+	if (TargetActor == nullptr || (ReapplyCooldown <= 0.0f && OverlapDedupWindow <= 0.0f))
+	{
+		return true;
+	}
+	
+	const double Now = GetWorld()->GetTimeSeconds();
+	CleanupExpiredApplyRecords(Now);
+	
+	FTargetApplyKey Key;
+	Key.Target = TargetActor;
+	Key.EffectClass = EffectClass.ToSoftObjectPath();
+	Key.Event = Event;
+	FTargetApplyRecord& Record = TargetApplyRecords.FindOrAdd(Key);
+	const bool bDuplicateEvent = Record.LastEventTime >= 0.0 && Now - Record.LastEventTime < OverlapDedupWindow;
+	const bool bCoolingDown = Record.LastApplyTime >= 0.0 && Now - Record.LastApplyTime < ReapplyCooldown;
+	Record.LastEventTime = Now;
+	
+	if (bDuplicateEvent || bCoolingDown)
+	{
+		++NumRejectedApplications;
+		INC_DWORD_STAT(STAT_AuraEffectApplicationsRejected);
+		return false;
+	}
+	
+	Record.LastApplyTime = Now;
+	return true;
 }
 
+void AAuraEffectActor::CleanupExpiredApplyRecords(double Now)
+{
+	// 超过最长窗口的记录已经不会影响判断，每隔一个窗口清理一次即可
+	const double ExpireTime = FMath::Max(ReapplyCooldown, OverlapDedupWindow);
+	if (Now - LastApplyRecordCleanupTime < ExpireTime)
+	{
+		return;
+	}
+	LastApplyRecordCleanupTime = Now;
+	
+	for (auto It = TargetApplyRecords.CreateIterator(); It; ++It)
+	{
+		const FTargetApplyRecord& Record = It.Value();
+		if (!It.Key().Target.IsValid() || Now - FMath::Max(Record.LastEventTime, Record.LastApplyTime) >= ExpireTime)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
 
+void AAuraEffectActor::ApplyInfiniteEffectToTarget(AActor* TargetActor)
+{
+	ActivateTargetAbilitySystem(TargetActor);
+	UAbilitySystemComponent* TargetASC = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(TargetActor);
+	if (TargetASC == nullptr) return;
+	
+	//已经施加过且仍然有效时不再重复施加，避免无限效果在同一个目标上越叠越多
+	if (const FActiveGameplayEffectHandle* ExistingHandle = ActiveInfiniteEffectHandles.Find(TargetASC))
+	{
+		if (TargetASC->GetActiveGameplayEffect(*ExistingHandle) != nullptr)
+		{
+			return;
+		}
+	}
+	
+	const FActiveGameplayEffectHandle ActiveEffectHandle = ApplyEffectToTarget(TargetActor, InfiniteGameplayEffectClass);
+	if (ActiveEffectHandle.IsValid())
+	{
+		ActiveInfiniteEffectHandles.Add(TargetASC, ActiveEffectHandle);
+	}
+}
+
+bool AAuraEffectActor::RemoveInfiniteEffectFromTarget(AActor* TargetActor)
+{
+	// 还没有创建能力系统的敌人身上不会有无限效果，这里不创建
+	UAbilitySystemComponent* TargetASC = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(TargetActor);
+	if (TargetASC == nullptr) return false;
+	
+	FActiveGameplayEffectHandle ActiveEffectHandle;
+	if (!ActiveInfiniteEffectHandles.RemoveAndCopyValue(TargetASC, ActiveEffectHandle))
+	{
+		return false;
+	}
+	
+	//只移除一层：效果按目标叠加时，其他Actor施加的层数不受影响
+	return TargetASC->RemoveActiveGameplayEffect(ActiveEffectHandle, 1);
+}
+
+void AAuraEffectActor::DestroyEffectActor()
+{
+	if (bPooled)
+	{
+		if (UAuraEffectActorPool* Pool = GetWorld()->GetSubsystem<UAuraEffectActorPool>())
+		{
+			Pool->ReleaseEffectActor(this);
+			return;
+		}
+	}
+	Destroy();
+}
+
+void AAuraEffectActor::ApplyEffectConfig(const FAuraEffectActorConfig& Config)
+{
+	InstanceGameplayEffectClass = Config.InstanceGameplayEffectClass;
+	InstanceEffectApplycationPolicy = Config.InstanceEffectApplycationPolicy;
+	DurationGameplayEffectClass = Config.DurationGameplayEffectClass;
+	DurationEffectApplycationPolicy = Config.DurationEffectApplycationPolicy;
+	InfiniteGameplayEffectClass = Config.InfiniteGameplayEffectClass;
+	InfiniteEffectApplycationPolicy = Config.InfiniteEffectApplycationPolicy;
+	InfinitEffectRemovePolicy = Config.InfinitEffectRemovePolicy;
+	bDestoryOnEffectRemoval = Config.bDestoryOnEffectRemoval;
+	EffectLevel = Config.EffectLevel;
+	CachedEffectSpecs.Reset();
+	RequestEffectClassPreload();
+	UAuraNetDormancySubsystem::NotifyActorActivity(this);
+}
+
+void AAuraEffectActor::ResetForPool()
+{
+	// 关闭碰撞时已经触发了结束重叠，按移除策略处理过的无限效果不会留在这里，剩下的只是记录
+	ActiveInfiniteEffectHandles.Reset();
+	TargetApplyRecords.Reset();
+	NumRejectedApplications = 0;
+	LastAreaEffectReport = FAuraAreaEffectReport();
+}
+
+#if !UE_BUILD_SHIPPING
+/**
+ * @brief 基准：比较每次重叠都创建上下文和规格（原来的做法）与复用缓存规格时，每次施加的耗时和内存分配
+ * 用法：Aura.EffectActor.SpecBenchmark [Applications=施加次数]，默认10000次；需要在服务器或单机的世界中运行（可以用-nullrhi无头启动）
+ * 日志只输出耗时；分配次数用Insights统计：以 -trace=cpu,memalloc -llm 启动，两段循环分别在LLM标签
+ * Aura/EffectSpec/PerOverlap和Aura/EffectSpec/Cached下，在Memory Insights中按标签查看这段时间内的分配
+ * @note 两条路径都包含ApplyGameplayEffectSpecToSelf本身的分配，差值就是创建规格和上下文的分配
+ */
+struct FAuraEffectActorSpecBenchmark
+{
+	static void Run(const TArray<FString>& Args, UWorld* World)
+	{
+		int32 Applications = 10000;
+		for (const FString& Arg : Args)
+		{
+			FParse::Value(*Arg, TEXT("Applications="), Applications);
+		}
+		Applications = FMath::Max(Applications, 1);
+
+		if (World == nullptr || World->GetNetMode() == NM_Client)
+		{
+			UE_LOG(LogAura, Warning, TEXT("Aura.EffectActor.SpecBenchmark 需要在服务器或单机的世界中运行"));
+			return;
+		}
+
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		SpawnParameters.ObjectFlags |= RF_Transient;
+		AAuraEffectActor* EffectActor = World->SpawnActor<AAuraEffectActor>(AAuraEffectActor::StaticClass(), FTransform::Identity, SpawnParameters);
+		UAbilitySystemComponent* TargetASC = AuraBenchmarkUtils::SpawnAbilitySystemActor(World);
+		if (EffectActor == nullptr || TargetASC == nullptr)
+		{
+			return;
+		}
+		AActor* TargetActor = TargetASC->GetOwner();
+
+		// 空的即时效果：没有修改器，施加本身的开销最小，分配主要来自规格和上下文
+		const TSubclassOf<UGameplayEffect> EffectClass = UGameplayEffect::StaticClass();
+		const TSoftClassPtr<UGameplayEffect> SoftEffectClass(EffectClass.Get());
+
+		// 原来的做法：每次施加都创建上下文和规格
+		auto ApplyUncached = [&]()
+		{
+			FGameplayEffectContextHandle EffectContextHandle = TargetASC->MakeEffectContext();
+			EffectContextHandle.AddSourceObject(EffectActor);
+			const FGameplayEffectSpecHandle EffectSpecHandle = TargetASC->MakeOutgoingSpec(EffectClass, EffectActor->EffectLevel, EffectContextHandle);
+			TargetASC->ApplyGameplayEffectSpecToSelf(*EffectSpecHandle.Data.Get());
+		};
+		ApplyUncached();
+		double UncachedTime = 0.0;
+		{
+			LLM_SCOPE_BYNAME(TEXT("Aura/EffectSpec/PerOverlap"));
+			TRACE_CPUPROFILER_EVENT_SCOPE(AuraEffectSpecBenchmark_PerOverlap);
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 i = 0; i < Applications; ++i)
+			{
+				ApplyUncached();
+			}
+			UncachedTime = FPlatformTime::Seconds() - StartTime;
+		}
+
+		// 缓存规格：第一次施加时创建，之后复用
+		EffectActor->ApplyEffectToTarget(TargetActor, SoftEffectClass);
+		double CachedTime = 0.0;
+		{
+			LLM_SCOPE_BYNAME(TEXT("Aura/EffectSpec/Cached"));
+			TRACE_CPUPROFILER_EVENT_SCOPE(AuraEffectSpecBenchmark_Cached);
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 i = 0; i < Applications; ++i)
+			{
+				EffectActor->ApplyEffectToTarget(TargetActor, SoftEffectClass);
+			}
+			CachedTime = FPlatformTime::Seconds() - StartTime;
+		}
+
+		UE_LOG(LogAura, Display, TEXT("Aura.EffectActor.SpecBenchmark %d applications: per-overlap spec %.3f us, cached spec %.3f us (per application); allocations under LLM tags Aura/EffectSpec/*"),
+			Applications, UncachedTime * 1e6 / Applications, CachedTime * 1e6 / Applications);
+
+		TargetActor->Destroy();
+		EffectActor->Destroy();
+	}
+};
 
+static FAutoConsoleCommandWithWorldAndArgs CCmdEffectActorSpecBenchmark(
+	TEXT("Aura.EffectActor.SpecBenchmark"),
+	TEXT("比较每次重叠创建效果规格和复用缓存规格的耗时，分配在LLM标签Aura/EffectSpec/*下（-trace=memalloc -llm）。参数：[Applications=N]，默认10000次"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&FAuraEffectActorSpecBenchmark::Run));
+#endif
@@ -0,0 +1,167 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Actor/AuraEffectActorPool.h"
+
+#include "Actor/AuraEffectActor.h"
+#include "Aura/Aura.h"
+#include "Game/AuraNetDormancySubsystem.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pooled Effect Actors Spawned"), STAT_AuraPooledEffectActorsSpawned, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pooled Effect Actors Reused"), STAT_AuraPooledEffectActorsReused, STATGROUP_Aura);
+
+AAuraEffectActor* UAuraEffectActorPool::AcquireEffectActor(TSubclassOf<AAuraEffectActor> EffectActorClass, const FTransform& SpawnTransform, const FAuraEffectActorConfig* Config)
+{
+	if (EffectActorClass == nullptr)
+	{
+		return nullptr;
+	}
+
+	AAuraEffectActor* EffectActor = nullptr;
+	if (FAuraEffectActorPoolBucket* Bucket = Buckets.Find(EffectActorClass))
+	{
+		// 从末尾取，跳过已经被外部销毁的Actor（例如关卡卸载）
+		while (EffectActor == nullptr && Bucket->FreeActors.Num() > 0)
+		{
+			AAuraEffectActor* Candidate = Bucket->FreeActors.Pop(false);
+			if (IsValid(Candidate))
+			{
+				EffectActor = Candidate;
+			}
+		}
+	}
+
+	if (EffectActor == nullptr)
+	{
+		EffectActor = SpawnPooledActor(EffectActorClass, SpawnTransform);
+		if (EffectActor == nullptr)
+		{
+			return nullptr;
+		}
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_AuraPooledEffectActorsReused);
+	}
+
+	if (Config)
+	{
+		EffectActor->ApplyEffectConfig(*Config);
+	}
+	ActivateActor(EffectActor, SpawnTransform);
+	EffectActor->OnActivatedFromPool();
+	return EffectActor;
+}
+
+AAuraEffectActor* UAuraEffectActorPool::K2_AcquireEffectActor(TSubclassOf<AAuraEffectActor> EffectActorClass, const FTransform& SpawnTransform, const FAuraEffectActorConfig& Config)
+{
+	return AcquireEffectActor(EffectActorClass, SpawnTransform, &Config);
+}
+
+void UAuraEffectActorPool::ReleaseEffectActor(AAuraEffectActor* EffectActor)
+{
+	if (!IsValid(EffectActor))
+	{
+		return;
+	}
+
+	// 不是对象池生成的Actor直接销毁，保证调用方的语义不变
+	if (!EffectActor->IsPooled())
+	{
+		EffectActor->Destroy();
+		return;
+	}
+
+	FAuraEffectActorPoolBucket& Bucket = Buckets.FindOrAdd(EffectActor->GetClass());
+	if (Bucket.FreeActors.Contains(EffectActor))
+	{
+		return;
+	}
+
+	// 先放回空闲列表再休眠：关闭碰撞触发的结束重叠可能在蓝图中再次"销毁"这个Actor并重入这里，
+	// 此时它已经在空闲列表中，直接返回，不会被加入两次
+	Bucket.FreeActors.Add(EffectActor);
+	DeactivateActor(EffectActor);
+	EffectActor->ResetForPool();
+}
+
+void UAuraEffectActorPool::Prewarm(TSubclassOf<AAuraEffectActor> EffectActorClass, int32 Count)
+{
+	if (EffectActorClass == nullptr)
+	{
+		return;
+	}
+
+	FAuraEffectActorPoolBucket& Bucket = Buckets.FindOrAdd(EffectActorClass);
+	for (int32 i = 0; i < Count; ++i)
+	{
+		if (AAuraEffectActor* EffectActor = SpawnPooledActor(EffectActorClass, FTransform::Identity))
+		{
+			DeactivateActor(EffectActor);
+			Bucket.FreeActors.Add(EffectActor);
+		}
+	}
+}
+
+int32 UAuraEffectActorPool::GetNumFreeActors(TSubclassOf<AAuraEffectActor> EffectActorClass) const
+{
+	const FAuraEffectActorPoolBucket* Bucket = Buckets.Find(EffectActorClass);
+	return Bucket ? Bucket->FreeActors.Num() : 0;
+}
+
+AAuraEffectActor* UAuraEffectActorPool::SpawnPooledActor(TSubclassOf<AAuraEffectActor> EffectActorClass, const FTransform& SpawnTransform)
+{
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AAuraEffectActor* EffectActor = GetWorld()->SpawnActor<AAuraEffectActor>(EffectActorClass, SpawnTransform, SpawnParameters);
+	if (EffectActor)
+	{
+		EffectActor->SetPooled(true);
+		INC_DWORD_STAT(STAT_AuraPooledEffectActorsSpawned);
+	}
+	return EffectActor;
+}
+
+void UAuraEffectActorPool::DeactivateActor(AAuraEffectActor* EffectActor)
+{
+	// 关闭碰撞会触发结束重叠，效果Actor会按移除策略移除自己施加的无限效果
+	EffectActor->SetActorEnableCollision(false);
+	EffectActor->SetActorHiddenInGame(true);
+	EffectActor->SetActorTickEnabled(false);
+
+	// 隐藏和关闭碰撞的状态会在进入休眠前最后复制一次
+	// 池中的Actor由对象池管理休眠，不再交给休眠子系统（否则取出时的移动会被当作活动）
+	if (EffectActor->HasAuthority())
+	{
+		EffectActor->SetNetDormancy(DORM_DormantAll);
+		if (UAuraNetDormancySubsystem* DormancySubsystem = EffectActor->GetWorld()->GetSubsystem<UAuraNetDormancySubsystem>())
+		{
+			DormancySubsystem->UnregisterActor(EffectActor);
+		}
+	}
+}
+
+void UAuraEffectActorPool::ActivateActor(AAuraEffectActor* EffectActor, const FTransform& SpawnTransform)
+{
+	if (EffectActor->HasAuthority())
+	{
+		EffectActor->SetNetDormancy(DORM_Awake);
+	}
+
+	EffectActor->SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::TeleportPhysics);
+	EffectActor->SetActorHiddenInGame(false);
+	EffectActor->SetActorEnableCollision(true);
+
+	// Tick只在范围模式下需要，和BeginPlay中的判断保持一致
+	EffectActor->RefreshAreaModeTick();
+
+	// 激活后重新交给休眠子系统，安静一段时间后再次休眠
+	if (EffectActor->HasAuthority())
+	{
+		if (UAuraNetDormancySubsystem* DormancySubsystem = EffectActor->GetWorld()->GetSubsystem<UAuraNetDormancySubsystem>())
+		{
+			DormancySubsystem->RegisterActor(EffectActor);
+		}
+	}
+}
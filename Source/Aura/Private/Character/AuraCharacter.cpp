@@ -28,32 +28,69 @@ void AAuraCharacter::InitAbilitySystemInfo()
     // - 所属者（AuraPlayerState）：ASC的实际拥有者，PlayerState跨角色切换时数据不丢失
     // - 化身角色（this，当前AuraCharacter）：ASC实际作用的角色，技能、属性效果应用于该角色
     // 核心逻辑：玩家角色的技能系统由PlayerState承载（全局持久），但作用于当前控制的角色
-    AuraPlayerState->GetAbilitySystemComponent()->InitAbilityActorInfo(AuraPlayerState, this);
+    // 服务器PossessedBy和客户端OnRep_PlayerState都会走到这里，PlayerState也可能重新复制：
+    // 拥有者、化身和控制器都没变时跳过，避免重复初始化ActorInfo
+    UAbilitySystemComponent* PlayerAbilitySystemComponent = AuraPlayerState->GetAbilitySystemComponent();
+    const FGameplayAbilityActorInfo* ActorInfo = PlayerAbilitySystemComponent->AbilityActorInfo.Get();
+    if (ActorInfo == nullptr
+        || ActorInfo->OwnerActor.Get() != AuraPlayerState
+        || ActorInfo->AvatarActor.Get() != this
+        || ActorInfo->PlayerController.Get() != GetController())
+    {
+        PlayerAbilitySystemComponent->InitAbilityActorInfo(AuraPlayerState, this);
+    }
     
     // 缓存PlayerState中的ASC到角色本地成员变量
     // 后续角色逻辑（如技能触发、属性查询）可直接通过本地引用访问，无需重复获取PlayerState
-    AbilitySysteamComponent = AuraPlayerState->GetAbilitySystemComponent();
+    AbilitySysteamComponent = PlayerAbilitySystemComponent;
     // 缓存PlayerState中的属性集（AttributeSet）到角色本地成员变量
     // 属性集存储角色核心属性（血量、蓝量、攻击力等），本地缓存方便快速访问
     AttributeSet = AuraPlayerState->GetAttributeSet();
+    
+    // 服务器上第一次初始化这个PlayerState的属性集时，按玩家类型和等级一次性写入初始属性
+    // 重生时PlayerState（以及属性）保留，不会重置
+    if (HasAuthority() && !AuraPlayerState->HasInitializedDefaultAttributes())
+    {
+        InitializeDefaultAttributes();
+        AuraPlayerState->MarkDefaultAttributesInitialized();
+    }
 	
 	// 判空玩家控制器（适配多人游戏架构核心逻辑）：
 	// 多人游戏中服务器持有所有玩家的PlayerController，而客户端仅持有自身的PlayerController；
 	// 若不判空，当客户端代码尝试获取其他玩家的PlayerController时会返回空指针，
 	// 直接调用后续GetHUD()/InitOverlay()会导致客户端崩溃，此判断规避该场景的致命错误
 	//if (AAuraPlayerController* AuraPlayerController = GetController<AAuraPlayerController>())//错误代码
+	AAuraHUD* AuraHUD = nullptr;
 	if (AAuraPlayerController*AuraPlayerController = Cast<AAuraPlayerController>(GetController()))
 	{
-		if (AAuraHUD* AuraHUD = Cast<AAuraHUD>(AuraPlayerController->GetHUD()))
+		//只有本地的玩家才具有AuraHUD服务器是不需要HUD的
+		AuraHUD = Cast<AAuraHUD>(AuraPlayerController->GetHUD());
+		if (AuraHUD)
 		{
-			//只有本地的玩家才具有AuraHUD服务器是不需要HUD的
 			//当函数执行到这里的时候可以确定HUD需要的元素都已经初始化完毕了
-			AuraHUD->InitOverlay(AuraPlayerController,AuraPlayerState,AbilitySysteamComponent,AttributeSet);	
+			//InitOverlay可以重复调用，参数没变时什么都不做，变化时只重新绑定
+			AuraHUD->InitOverlay(this,AuraPlayerController,AuraPlayerState,AbilitySysteamComponent,AttributeSet);	
 		}
 	}
-	
-	
-	
+
+	//换了HUD（或者不再有HUD）时释放旧HUD上的引用
+	if (OverlayHUD.IsValid() && OverlayHUD.Get() != AuraHUD)
+	{
+		OverlayHUD->ReleaseOverlay(this);
+	}
+	OverlayHUD = AuraHUD;
+}
+
+void AAuraCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// 角色销毁（死亡、切换地图）时释放Overlay引用，没有使用者的Overlay不会继续接收属性广播
+	if (AAuraHUD* AuraHUD = OverlayHUD.Get())
+	{
+		AuraHUD->ReleaseOverlay(this);
+	}
+	OverlayHUD.Reset();
+
+	Super::EndPlay(EndPlayReason);
 }
 
 /**
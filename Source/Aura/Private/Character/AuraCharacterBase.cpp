@@ -3,11 +3,16 @@
 
 #include "Character/AuraCharacterBase.h"
 
+#include "AbilitySystem/AuraAttributeDefaultsSubsystem.h"
+#include "AbilitySystem/AuraDerivedAttributeSubsystem.h"
+#include "Character/AuraSignificanceSubsystem.h"
+#include "Interaction/EnemyInterface.h"
+
 // Sets default values
 AAuraCharacterBase::AAuraCharacterBase()
 {
- 	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+ 	// 角色本身没有Tick逻辑，关闭Actor的Tick；组件的Tick频率由重要性子系统（UAuraSignificanceSubsystem）统一调度
+	PrimaryActorTick.bCanEverTick = false;
 	Weapon = CreateDefaultSubobject<USkeletalMeshComponent>("Weapon");
 	Weapon->SetupAttachment(GetMesh(), FName("WeaponHandSocket"));
 	Weapon->SetCollisionEnabled(ECollisionEnabled::NoCollision);
@@ -22,7 +27,52 @@ UAbilitySystemComponent* AAuraCharacterBase::GetAbilitySystemComponent() const
 void AAuraCharacterBase::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	if (UAuraSignificanceSubsystem* SignificanceSubsystem = GetWorld()->GetSubsystem<UAuraSignificanceSubsystem>())
+	{
+		SignificanceSubsystem->RegisterCharacter(this);
+	}
+}
+
+void AAuraCharacterBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UAuraSignificanceSubsystem* SignificanceSubsystem = GetWorld()->GetSubsystem<UAuraSignificanceSubsystem>())
+	{
+		SignificanceSubsystem->UnregisterCharacter(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AAuraCharacterBase::InitializeDefaultAttributes() const
+{
+	// 属性只在服务器上初始化，客户端通过属性复制得到
+	if (AbilitySysteamComponent == nullptr || !HasAuthority())
+	{
+		return;
+	}
+	UAuraAttributeDefaultsSubsystem* DefaultsSubsystem = UAuraAttributeDefaultsSubsystem::Get(this);
+	if (DefaultsSubsystem && !AttributeDefaultsName.IsNone())
+	{
+		DefaultsSubsystem->ApplyDefaults(AbilitySysteamComponent, AttributeDefaultsName, CharacterLevel);
+	}
+
+	// 主属性写入之后注册推导，次级属性在下一帧统一计算，之后只在来源属性变化时重新计算
+	// 敌人的推导结果受难度缩放影响
+	if (UAuraDerivedAttributeSubsystem* DerivedSubsystem = GetWorld()->GetSubsystem<UAuraDerivedAttributeSubsystem>())
+	{
+		DerivedSubsystem->RegisterAbilitySystem(AbilitySysteamComponent, Implements<UEnemyInterface>());
+	}
+}
+
+void AAuraCharacterBase::MarkInCombat()
+{
+	LastCombatTime = GetWorld()->GetTimeSeconds();
+}
+
+bool AAuraCharacterBase::IsInCombat() const
+{
+	return GetWorld()->GetTimeSeconds() - LastCombatTime < CombatTimeout;
 }
 
 
@@ -4,8 +4,14 @@
 #include "Character/AuraEnemyCharacter.h"
 
 #include "AbilitySystem/AuraAbilitySystemComponent.h"
+#include "AbilitySystem/AuraAttributeDefaultsSubsystem.h"
 #include "AbilitySystem/AuraAttributeSet.h"
+#include "AbilitySystem/AuraDerivedAttributeSubsystem.h"
+#include "AbilitySystem/AuraEnemyAttributeStore.h"
 #include "Aura/Aura.h"
+#include "Game/AuraNetDormancySubsystem.h"
+#include "GameplayEffect.h"
+#include "Interaction/AuraHighlightSubsystem.h"
 AAuraEnemyCharacter::AAuraEnemyCharacter()
 {
 	// 设置角色网格体（Mesh）对“可见性碰撞通道（ECC_Visibility）”的碰撞响应为“阻挡（ECR_Block）”
@@ -17,9 +23,39 @@ AAuraEnemyCharacter::AAuraEnemyCharacter()
 	// 若需取消选中检测，可改为ECR_Ignore（忽略）；若需仅检测不阻挡，可改为ECR_Overlap（重叠）
 	GetMesh()->SetCollisionResponseToChannel(ECC_Visibility,ECR_Block);
 	
+	// 延迟创建模式下构造时不创建能力系统组件和属性集，大量闲置敌人只占用DormantVitals这一条默认属性记录
+	// 等到第一次被仇恨、受伤或被悬停时再由ActivateAbilitySystem在服务器上创建，然后复制到客户端
+	bLazyAbilitySystem = IsLazyAbilitySystemEnabled();
+	if (!bLazyAbilitySystem)
+	{
+		CreateAbilitySystem(true);
+	}
+
+	// 模板值在构造时就设置好，高亮/取消高亮时只需要切换自定义深度渲染的开关
+	// 模板值用于后期处理时“精准识别该物体”，配合后处理材质（如仅对模板值为CUSTOM_DEPTH_RED的物体应用高亮）
+	GetMesh()->CustomDepthStencilValue = CUSTOM_DEPTH_RED;
+	Weapon->CustomDepthStencilValue = CUSTOM_DEPTH_RED;
+}
+bool AAuraEnemyCharacter::IsLazyAbilitySystemEnabled()
+{
+	// 构造函数里不能依赖Config属性（实例的属性在构造之后才从CDO拷贝），所以直接读一次ini并缓存
+	static const bool bLazy = []()
+	{
+		bool bValue = false;
+		GConfig->GetBool(TEXT("/Script/Aura.AuraEnemyCharacter"), TEXT("bLazyAbilitySystem"), bValue, GGameIni);
+		return bValue;
+	}();
+	return bLazy;
+}
+
+void AAuraEnemyCharacter::CreateAbilitySystem(bool bAsDefaultSubobject)
+{
 	// 1. 创建Aura自定义的能力系统组件（UAurabilitySystemComponent），命名为"AbilitySysteam"
 	// 核心作用：作为GAS（Gameplay Ability System）的核心载体，负责管理角色的能力（Abilities）、游戏玩法效果（Gameplay Effects）、属性（AttributeSet）等核心逻辑
-	AbilitySysteamComponent = CreateDefaultSubobject<UAuraAbilitySystemComponent>("AbilitySysteamComponent");
+	UAuraAbilitySystemComponent* AuraAbilitySystemComponent = bAsDefaultSubobject
+		? CreateDefaultSubobject<UAuraAbilitySystemComponent>("AbilitySysteamComponent")
+		: NewObject<UAuraAbilitySystemComponent>(this, "AbilitySysteamComponent");
+	AbilitySysteamComponent = AuraAbilitySystemComponent;
 
 	// 2. 设置能力系统组件为"可复制"
 	// 关键作用：启用组件的网络同步功能，让服务器端的能力相关状态（如技能触发、效果生效）能按复制模式同步到客户端，多人游戏必需配置
@@ -30,51 +66,183 @@ AAuraEnemyCharacter::AAuraEnemyCharacter()
 	// 核心价值：减少网络带宽冗余消耗，同时保证所有客户端能看到AI的视觉反馈和状态标签，平衡性能与体验一致性
 	AbilitySysteamComponent->SetReplicationMode(EGameplayEffectReplicationMode::Minimal);
 	
+	// 开启按连接的属性复制策略：远处和未交互的敌人降低血量同步频率，悬停/附近的敌人全频率同步
+	// 具体距离和间隔可以在敌人蓝图的AbilitySysteamComponent上调整
+	AuraAbilitySystemComponent->AttributeReplicationPolicy.bEnabled = true;
+	
 	// 4. 创建Aura自定义的属性集组件（UAuraAttributeSet），命名为"AttributeSet"
 	// 核心作用：集中存储角色的可修改属性（如血量、蓝量、攻击力、防御力），由能力系统组件统一管理，属性变化会通过GAS自动同步
-	AttributeSet = CreateDefaultSubobject<UAuraAttributeSet>("AttributeSet");
+	AttributeSet = bAsDefaultSubobject
+		? CreateDefaultSubobject<UAuraAttributeSet>("AttributeSet")
+		: NewObject<UAuraAttributeSet>(this, "AttributeSet");
+}
 
-	
+void AAuraEnemyCharacter::InitAbilitySystem()
+{
+	if (AbilitySysteamComponent)
+	{
+		//初始化能力组件的拥有者和生效者都是该对象自身
+		AbilitySysteamComponent->InitAbilityActorInfo(this,this);
+
+		// 效果添加/移除时唤醒休眠的敌人（属性变化在属性集中处理）
+		if (HasAuthority())
+		{
+			// 按敌人类型和等级一次性写入初始属性，不需要再应用初始化效果
+			InitializeDefaultAttributes();
+
+			AbilitySysteamComponent->OnActiveGameplayEffectAddedDelegateToSelf.AddWeakLambda(this,
+				[this](UAbilitySystemComponent*, const FGameplayEffectSpec&, FActiveGameplayEffectHandle)
+				{
+					UAuraNetDormancySubsystem::NotifyActorActivity(this);
+				});
+			AbilitySysteamComponent->OnAnyGameplayEffectRemovedDelegate().AddWeakLambda(this,
+				[this](const FActiveGameplayEffect&)
+				{
+					UAuraNetDormancySubsystem::NotifyActorActivity(this);
+				});
+		}
+	}
+	BindAttributeStore();
 }
-void AAuraEnemyCharacter::HightLightEnemy()
+
+void AAuraEnemyCharacter::BindAttributeStore()
 {
-	
-	// 启用角色网格体的“自定义深度渲染”功能
-	// 开启后，该网格体的深度信息会被写入独立的自定义深度缓冲区，用于后续后期处理（如描边、高亮）
-	GetMesh()->SetRenderCustomDepth(true);
+	// 属性集注册到属性仓库，死亡检查、回复、血条按列批量遍历所有敌人
+	UAuraAttributeSet* AuraAttributeSet = Cast<UAuraAttributeSet>(AttributeSet);
+	if (AuraAttributeSet && (HasActorBegunPlay() || IsActorBeginningPlay()))
+	{
+		AuraAttributeSet->BindAttributeStore(GetWorld()->GetSubsystem<UAuraEnemyAttributeStore>());
+	}
+}
 
-	// 设置角色网格体的“自定义深度模板值”为红色通道标识
-	// 模板值用于后期处理时“精准识别该物体”，配合后处理材质（如仅对模板值为CUSTOM_DEPTH_RED的物体应用高亮）
-	GetMesh()->SetCustomDepthStencilValue(CUSTOM_DEPTH_RED);
+void AAuraEnemyCharacter::ActivateAbilitySystem()
+{
+	// 只有服务器能创建，客户端的组件由复制创建（见OnSubobjectCreatedFromReplication）
+	if (AbilitySysteamComponent || !HasAuthority() || !HasActorBegunPlay())
+	{
+		return;
+	}
 
-	// 启用武器的“自定义深度渲染”功能
-	// 使武器的深度信息也被纳入自定义深度缓冲区，支持和角色统一的后期处理逻辑
-	Weapon->SetRenderCustomDepth(true);
-	
-	// 设置武器的“自定义深度模板值”为红色通道标识
-	// 让武器和角色使用相同的模板值，确保后期处理时（如高亮）能同时作用于角色和武器
-	Weapon->SetCustomDepthStencilValue(CUSTOM_DEPTH_RED);
-	
-	
-	
+	CreateAbilitySystem(false);
+
+	// 用默认属性记录初始化属性集，延迟创建前后敌人的属性保持一致（配置了默认值表时InitAbilitySystem会再按表写入一次）
+	UAuraAttributeSet* AuraAttributeSet = CastChecked<UAuraAttributeSet>(AttributeSet);
+	AuraAttributeSet->InitMaxHealth(DormantVitals.MaxHealth);
+	AuraAttributeSet->InitHealth(DormantVitals.Health);
+	AuraAttributeSet->InitMaxMana(DormantVitals.MaxMana);
+	AuraAttributeSet->InitMana(DormantVitals.Mana);
+
+	// 组件注册后属性集才能作为能力系统组件的子对象复制
+	AbilitySysteamComponent->RegisterComponent();
+	AbilitySysteamComponent->AddAttributeSetSubobject(AuraAttributeSet);
+	InitAbilitySystem();
+
+	// 新创建的组件需要复制给客户端，休眠中的敌人要先唤醒
+	UAuraNetDormancySubsystem::NotifyActorActivity(this);
+}
+
+void AAuraEnemyCharacter::OnSubobjectCreatedFromReplication(UObject* NewSubobject)
+{
+	Super::OnSubobjectCreatedFromReplication(NewSubobject);
+
+	// 客户端：服务器延迟创建的能力系统组件和属性集复制过来时接上指针
+	if (UAbilitySystemComponent* NewAbilitySystemComponent = Cast<UAbilitySystemComponent>(NewSubobject))
+	{
+		AbilitySysteamComponent = NewAbilitySystemComponent;
+		InitAbilitySystem();
+	}
+	else if (UAttributeSet* NewAttributeSet = Cast<UAttributeSet>(NewSubobject))
+	{
+		AttributeSet = NewAttributeSet;
+		BindAttributeStore();
+	}
+}
+
+void AAuraEnemyCharacter::HightLightEnemy()
+{
+	// 高亮请求交给高亮子系统收集，帧末统一提交渲染状态；没有子系统（专用服务器）时直接修改
+	if (UAuraHighlightSubsystem* HighlightSubsystem = GetWorld()->GetSubsystem<UAuraHighlightSubsystem>())
+	{
+		HighlightSubsystem->AddHighlightSource(this, EAuraHighlightSource::Hover);
+		return;
+	}
+	ApplyHighlightRenderState(true);
 }
 
 void AAuraEnemyCharacter::UnHightLightEnemy()
 {
-	
-	//关闭角色网格体的“自定义深度渲染”功能
-	GetMesh()->SetRenderCustomDepth(false);
-	
-	//关闭武器的“自定义深度渲染”功能
-	Weapon->SetCustomDepthStencilValue(false);
+	if (UAuraHighlightSubsystem* HighlightSubsystem = GetWorld()->GetSubsystem<UAuraHighlightSubsystem>())
+	{
+		HighlightSubsystem->RemoveHighlightSource(this, EAuraHighlightSource::Hover);
+		return;
+	}
+	ApplyHighlightRenderState(false);
+}
+
+/**
+ * 修改角色网格体和武器的“自定义深度渲染”开关
+ * 开启后网格体的深度信息会被写入独立的自定义深度缓冲区，用于后续后期处理（如描边、高亮）
+ * 直接修改属性后每个组件只标记一次渲染状态为脏，避免SetRenderCustomDepth/SetCustomDepthStencilValue各标记一次
+ */
+void AAuraEnemyCharacter::ApplyHighlightRenderState(bool bHighlighted)
+{
+	for (UPrimitiveComponent* Component : { static_cast<UPrimitiveComponent*>(GetMesh()), static_cast<UPrimitiveComponent*>(Weapon.Get()) })
+	{
+		if (Component == nullptr)
+		{
+			continue;
+		}
+		if (Component->bRenderCustomDepth != bHighlighted || Component->CustomDepthStencilValue != CUSTOM_DEPTH_RED)
+		{
+			Component->bRenderCustomDepth = bHighlighted;
+			Component->CustomDepthStencilValue = CUSTOM_DEPTH_RED;
+			Component->MarkRenderStateDirty();
+		}
+	}
 }
 
 void AAuraEnemyCharacter::BeginPlay()
 {
 	Super::BeginPlay();	
-	if (AbilitySysteamComponent)
+	InitAbilitySystem();
+
+	// 延迟创建模式下默认属性记录也从默认值表取值，和之后创建的属性集保持一致
+	if (AbilitySysteamComponent == nullptr && HasAuthority())
 	{
-		//初始化能力组件的拥有者和生效者都是该对象自身
-		AbilitySysteamComponent->InitAbilityActorInfo(this,this);
+		UAuraAttributeDefaultsSubsystem* DefaultsSubsystem = UAuraAttributeDefaultsSubsystem::Get(this);
+		if (const FAuraBakedAttributeDefaults* Defaults = DefaultsSubsystem ? DefaultsSubsystem->FindDefaults(AttributeDefaultsName, CharacterLevel) : nullptr)
+		{
+			DormantVitals.Health = Defaults->GetValue(UAuraAttributeSet::GetHealthAttribute(), DormantVitals.Health);
+			DormantVitals.MaxHealth = Defaults->GetValue(UAuraAttributeSet::GetMaxHealthAttribute(), DormantVitals.MaxHealth);
+			DormantVitals.Mana = Defaults->GetValue(UAuraAttributeSet::GetManaAttribute(), DormantVitals.Mana);
+			DormantVitals.MaxMana = Defaults->GetValue(UAuraAttributeSet::GetMaxManaAttribute(), DormantVitals.MaxMana);
+		}
 	}
+
+	// 闲置的敌人安静一段时间后进入网络休眠
+	if (HasAuthority())
+	{
+		if (UAuraNetDormancySubsystem* DormancySubsystem = GetWorld()->GetSubsystem<UAuraNetDormancySubsystem>())
+		{
+			DormancySubsystem->RegisterActor(this);
+		}
+	}
+}
+
+void AAuraEnemyCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UAuraAttributeSet* AuraAttributeSet = Cast<UAuraAttributeSet>(AttributeSet))
+	{
+		AuraAttributeSet->UnbindAttributeStore();
+	}
+	if (UAuraDerivedAttributeSubsystem* DerivedSubsystem = GetWorld()->GetSubsystem<UAuraDerivedAttributeSubsystem>())
+	{
+		DerivedSubsystem->UnregisterAbilitySystem(AbilitySysteamComponent);
+	}
+	if (UAuraNetDormancySubsystem* DormancySubsystem = GetWorld()->GetSubsystem<UAuraNetDormancySubsystem>())
+	{
+		DormancySubsystem->UnregisterActor(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
@@ -0,0 +1,514 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Character/AuraSignificanceSubsystem.h"
+
+#include "Aura/Aura.h"
+#include "Aura/AuraBenchmarkUtils.h"
+#include "Character/AuraCharacterBase.h"
+#include "Character/AuraEnemyCharacter.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Significance Update"), STAT_AuraSignificanceUpdate, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Significance Changes"), STAT_AuraSignificanceChanges, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Characters Critical"), STAT_AuraSignificanceCritical, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Characters Culled"), STAT_AuraSignificanceCulled, STATGROUP_Aura);
+
+static TAutoConsoleVariable<bool> CVarAuraSignificanceEnabled(
+	TEXT("Aura.Significance.Enabled"),
+	true,
+	TEXT("是否按重要性调度角色的Tick频率，关闭后所有角色每帧更新（用于对比耗时）"));
+
+static_assert(sizeof(UAuraSignificanceSubsystem::LevelSettings) / sizeof(FAuraSignificanceSettings) == (int32)EAuraSignificance::Num, "LevelSettings必须和EAuraSignificance一一对应");
+
+UAuraSignificanceSubsystem::UAuraSignificanceSubsystem()
+{
+	// 默认设置，可以在DefaultGame.ini的[/Script/Aura.AuraSignificanceSubsystem]中覆盖
+	LevelSettings[(int32)EAuraSignificance::Critical] = { 0.0f, 0.0f, true };
+	LevelSettings[(int32)EAuraSignificance::High] = { 0.0f, 1.0f / 30.0f, true };
+	LevelSettings[(int32)EAuraSignificance::Medium] = { 1.0f / 15.0f, 1.0f / 15.0f, true };
+	LevelSettings[(int32)EAuraSignificance::Low] = { 0.2f, 0.5f, true };
+	LevelSettings[(int32)EAuraSignificance::Culled] = { 0.5f, 1.0f, false };
+}
+
+void UAuraSignificanceSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const bool bEnabled = CVarAuraSignificanceEnabled.GetValueOnGameThread();
+	if (!bEnabled)
+	{
+		if (bWasEnabled)
+		{
+			// 刚关闭调度：所有角色恢复默认设置，下次开启时重新评分
+			for (auto& Pair : Characters)
+			{
+				if (AAuraCharacterBase* Character = Pair.Key.Get())
+				{
+					RestoreDefaults(Character, Pair.Value);
+				}
+				Pair.Value = FTrackedCharacter();
+			}
+			bWasEnabled = false;
+		}
+		return;
+	}
+	bWasEnabled = true;
+
+	TimeSinceLastUpdate += DeltaTime;
+	if (TimeSinceLastUpdate < UpdateInterval)
+	{
+		return;
+	}
+	TimeSinceLastUpdate = 0.0f;
+
+	SCOPE_CYCLE_COUNTER(STAT_AuraSignificanceUpdate);
+
+	FViewLocations ViewLocations;
+	GatherViewLocations(ViewLocations);
+
+	int32 NumCritical = 0;
+	int32 NumCulled = 0;
+	for (auto It = Characters.CreateIterator(); It; ++It)
+	{
+		AAuraCharacterBase* Character = It->Key.Get();
+		if (Character == nullptr)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		const EAuraSignificance NewSignificance = EvaluateSignificance(Character, ViewLocations);
+		if (NewSignificance != It->Value.Significance)
+		{
+			ApplySignificance(Character, It->Value, NewSignificance);
+			It->Value.Significance = NewSignificance;
+			INC_DWORD_STAT(STAT_AuraSignificanceChanges);
+		}
+
+		NumCritical += NewSignificance == EAuraSignificance::Critical;
+		NumCulled += NewSignificance == EAuraSignificance::Culled;
+	}
+	SET_DWORD_STAT(STAT_AuraSignificanceCritical, NumCritical);
+	SET_DWORD_STAT(STAT_AuraSignificanceCulled, NumCulled);
+}
+
+TStatId UAuraSignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAuraSignificanceSubsystem, STATGROUP_Tickables);
+}
+
+void UAuraSignificanceSubsystem::RegisterCharacter(AAuraCharacterBase* Character)
+{
+	// 新注册的角色按Critical（默认设置）处理，下次评分时再降级
+	Characters.Add(Character, FTrackedCharacter());
+	// 让新角色在下一帧就被评分，避免大量刷怪时都以最高频率跑满一个更新间隔
+	TimeSinceLastUpdate = UpdateInterval;
+}
+
+void UAuraSignificanceSubsystem::UnregisterCharacter(AAuraCharacterBase* Character)
+{
+	Characters.Remove(Character);
+}
+
+EAuraSignificance UAuraSignificanceSubsystem::GetSignificance(const AAuraCharacterBase* Character) const
+{
+	const FTrackedCharacter* Tracked = Characters.Find(Character);
+	return Tracked ? Tracked->Significance : EAuraSignificance::Critical;
+}
+
+EAuraSignificance UAuraSignificanceSubsystem::EvaluateSignificance(const AAuraCharacterBase* Character, const FViewLocations& ViewLocations) const
+{
+	// 本地玩家控制的角色始终是最重要的
+	if (Character->IsLocallyControlled() && Character->IsPlayerControlled())
+	{
+		return EAuraSignificance::Critical;
+	}
+
+	const FVector CharacterLocation = Character->GetActorLocation();
+	float MinDistanceSquared = UE_BIG_NUMBER;
+	for (const FVector& ViewLocation : ViewLocations.Local)
+	{
+		MinDistanceSquared = FMath::Min(MinDistanceSquared, (float)FVector::DistSquared(ViewLocation, CharacterLocation));
+	}
+	float MinRemoteDistanceSquared = UE_BIG_NUMBER;
+	for (const FVector& ViewLocation : ViewLocations.Remote)
+	{
+		MinRemoteDistanceSquared = FMath::Min(MinRemoteDistanceSquared, (float)FVector::DistSquared(ViewLocation, CharacterLocation));
+	}
+	MinDistanceSquared = FMath::Min(MinDistanceSquared, MinRemoteDistanceSquared);
+
+	// 专用服务器上没有渲染，只按距离评分；监听服务器的渲染测试只代表主机玩家，远程玩家附近的角色当作可见
+	const bool bVisible = IsRunningDedicatedServer()
+		|| MinRemoteDistanceSquared <= FMath::Square(HighDistance)
+		|| Character->WasRecentlyRendered(RecentlyRenderedTolerance);
+
+	EAuraSignificance Significance;
+	if (MinDistanceSquared > FMath::Square(CullDistance) && !bVisible)
+	{
+		Significance = EAuraSignificance::Culled;
+	}
+	else if (!bVisible)
+	{
+		Significance = EAuraSignificance::Low;
+	}
+	else if (MinDistanceSquared <= FMath::Square(CriticalDistance))
+	{
+		Significance = EAuraSignificance::Critical;
+	}
+	else if (MinDistanceSquared <= FMath::Square(HighDistance))
+	{
+		Significance = EAuraSignificance::High;
+	}
+	else
+	{
+		Significance = EAuraSignificance::Medium;
+	}
+
+	// 战斗中的角色至少是High
+	if (Character->IsInCombat() && Significance > EAuraSignificance::High)
+	{
+		Significance = EAuraSignificance::High;
+	}
+	return Significance;
+}
+
+void UAuraSignificanceSubsystem::ApplySignificance(AAuraCharacterBase* Character, FTrackedCharacter& Tracked, EAuraSignificance Significance) const
+{
+	const FAuraSignificanceSettings& Settings = LevelSettings[(int32)Significance];
+
+	// 角色基类已经关闭了Actor Tick，只有蓝图子类开启了Tick时才需要调度
+	if (Character->PrimaryActorTick.bCanEverTick)
+	{
+		if (!Tracked.bHasSavedActorTick)
+		{
+			Tracked.SavedActorTick.bTickEnabled = Character->IsActorTickEnabled();
+			Tracked.SavedActorTick.TickInterval = Character->GetActorTickInterval();
+			Tracked.bHasSavedActorTick = true;
+		}
+		if (Tracked.SavedActorTick.bTickEnabled)
+		{
+			Character->SetActorTickInterval(FMath::Max(Settings.TickInterval, Tracked.SavedActorTick.TickInterval));
+			Character->SetActorTickEnabled(Settings.bEnableComponentTicks);
+		}
+	}
+
+	for (UActorComponent* Component : Character->GetComponents())
+	{
+		if (Component == nullptr || !Component->PrimaryComponentTick.bCanEverTick)
+		{
+			continue;
+		}
+
+		USkeletalMeshComponent* MeshComponent = Cast<USkeletalMeshComponent>(Component);
+		const FSavedTickState* Saved = Tracked.SavedComponentTicks.Find(Component);
+		if (Saved == nullptr)
+		{
+			FSavedTickState State;
+			State.bTickEnabled = Component->IsComponentTickEnabled();
+			State.TickInterval = Component->GetComponentTickInterval();
+			if (MeshComponent)
+			{
+				State.VisibilityBasedAnimTickOption = (uint8)MeshComponent->VisibilityBasedAnimTickOption;
+			}
+			Saved = &Tracked.SavedComponentTicks.Add(Component, State);
+		}
+
+		// 原本就关闭Tick的组件由它自己管理（例如GameplayTasks有任务时才开启），调度不去碰它
+		if (!Saved->bTickEnabled)
+		{
+			continue;
+		}
+
+		if (UCharacterMovementComponent* MovementComponent = Cast<UCharacterMovementComponent>(Component))
+		{
+			// 移动组件不关闭，服务器要用它驱动移动，客户端要用它做平滑
+			MovementComponent->SetComponentTickInterval(FMath::Max(Settings.TickInterval, Saved->TickInterval));
+		}
+		else if (MeshComponent)
+		{
+			MeshComponent->SetComponentTickInterval(FMath::Max(Settings.AnimTickInterval, Saved->TickInterval));
+			// 被剔除的角色不可见时只更新蒙太奇，其他等级恢复原来的设置
+			MeshComponent->VisibilityBasedAnimTickOption = Settings.bEnableComponentTicks
+				? (EVisibilityBasedAnimTickOption)Saved->VisibilityBasedAnimTickOption
+				: EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+		}
+		else
+		{
+			Component->SetComponentTickInterval(FMath::Max(Settings.TickInterval, Saved->TickInterval));
+			Component->SetComponentTickEnabled(Settings.bEnableComponentTicks);
+		}
+	}
+}
+
+void UAuraSignificanceSubsystem::RestoreDefaults(AAuraCharacterBase* Character, FTrackedCharacter& Tracked) const
+{
+	if (Tracked.bHasSavedActorTick && Tracked.SavedActorTick.bTickEnabled)
+	{
+		Character->SetActorTickInterval(Tracked.SavedActorTick.TickInterval);
+		Character->SetActorTickEnabled(true);
+	}
+
+	// 只写回调度修改过的组件（原本开启Tick的），原本关闭的组件可能已经自己开启了Tick
+	for (const TPair<TWeakObjectPtr<UActorComponent>, FSavedTickState>& Pair : Tracked.SavedComponentTicks)
+	{
+		UActorComponent* Component = Pair.Key.Get();
+		if (Component == nullptr || !Pair.Value.bTickEnabled)
+		{
+			continue;
+		}
+		Component->SetComponentTickInterval(Pair.Value.TickInterval);
+		Component->SetComponentTickEnabled(true);
+		if (USkeletalMeshComponent* MeshComponent = Cast<USkeletalMeshComponent>(Component))
+		{
+			MeshComponent->VisibilityBasedAnimTickOption = (EVisibilityBasedAnimTickOption)Pair.Value.VisibilityBasedAnimTickOption;
+		}
+	}
+
+	Tracked = FTrackedCharacter();
+}
+
+void UAuraSignificanceSubsystem::GatherViewLocations(FViewLocations& OutViewLocations) const
+{
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APlayerController* PlayerController = It->Get())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			if (PlayerController->IsLocalController())
+			{
+				OutViewLocations.Local.Add(ViewLocation);
+			}
+			else
+			{
+				OutViewLocations.Remote.Add(ViewLocation);
+			}
+		}
+	}
+}
+
+#if !UE_BUILD_SHIPPING
+/**
+ * @brief 无头基准：不同敌人数量下，开启和关闭重要性调度时每帧世界Tick（Actor和组件Tick）的游戏线程耗时
+ * 用法：Aura.Significance.Benchmark [敌人数量...] [Frames=帧数] [Class=敌人类路径]，默认100、500、1000个敌人各统计300帧
+ * 可以用-nullrhi无头运行（没有渲染时所有敌人都算不可见，按距离分为Low和Culled）；
+ * 默认用C++敌人类（没有网格体和动画），传入敌人蓝图的类路径可以包含动画的开销
+ * 敌人在第一个玩家周围按网格排开，范围覆盖剔除距离，每个数量依次：预热 → 开启调度统计 → 关闭调度统计
+ */
+namespace AuraSignificanceBenchmark
+{
+	enum class EPhase : uint8
+	{
+		WarmupScheduled,
+		MeasureScheduled,
+		WarmupUnscheduled,
+		MeasureUnscheduled,
+	};
+
+	//预热帧数：等重要性子系统至少评分一次、调度设置生效
+	static constexpr int32 WarmupFrames = 60;
+
+	struct FRun
+	{
+		TWeakObjectPtr<UWorld> World;
+		TSubclassOf<AAuraCharacterBase> CharacterClass;
+		TArray<int32> Counts;
+		int32 CountIndex = 0;
+		int32 Frames = 300;
+		bool bOriginalEnabled = true;
+
+		TArray<TWeakObjectPtr<AActor>> Spawned;
+		EPhase Phase = EPhase::WarmupScheduled;
+		int32 FrameInPhase = 0;
+		double TickStartTime = 0.0;
+		double MeasuredSeconds = 0.0;
+		double ScheduledMilliseconds = 0.0;
+
+		FDelegateHandle TickStartHandle;
+		FDelegateHandle PostActorTickHandle;
+	};
+
+	static TUniquePtr<FRun> ActiveRun;
+
+	static void SetSchedulingEnabled(bool bEnabled)
+	{
+		CVarAuraSignificanceEnabled.AsVariable()->Set(bEnabled, ECVF_SetByConsole);
+	}
+
+	static void DestroySpawned()
+	{
+		for (const TWeakObjectPtr<AActor>& Actor : ActiveRun->Spawned)
+		{
+			if (Actor.IsValid())
+			{
+				Actor->Destroy();
+			}
+		}
+		ActiveRun->Spawned.Reset();
+	}
+
+	static void Finish()
+	{
+		if (!ActiveRun.IsValid())
+		{
+			return;
+		}
+		FWorldDelegates::OnWorldTickStart.Remove(ActiveRun->TickStartHandle);
+		FWorldDelegates::OnWorldPostActorTick.Remove(ActiveRun->PostActorTickHandle);
+		DestroySpawned();
+		SetSchedulingEnabled(ActiveRun->bOriginalEnabled);
+		ActiveRun.Reset();
+	}
+
+	//生成当前数量的敌人，范围是剔除距离的1.25倍，保证每个重要性等级都有敌人
+	static void SpawnCurrentCount(UWorld* World)
+	{
+		const int32 Count = ActiveRun->Counts[ActiveRun->CountIndex];
+		const UAuraSignificanceSubsystem* Subsystem = World->GetSubsystem<UAuraSignificanceSubsystem>();
+		const float HalfExtent = (Subsystem ? Subsystem->CullDistance : 8000.0f) * 1.25f;
+
+		FVector Center = FVector::ZeroVector;
+		if (const APlayerController* PlayerController = World->GetFirstPlayerController())
+		{
+			if (const APawn* Pawn = PlayerController->GetPawn())
+			{
+				Center = Pawn->GetActorLocation();
+			}
+		}
+
+		const int32 GridSize = FMath::Max(FMath::CeilToInt(FMath::Sqrt(static_cast<float>(Count))), 1);
+		const float Spacing = HalfExtent * 2.0f / GridSize;
+
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		SpawnParameters.ObjectFlags |= RF_Transient;
+		for (int32 i = 0; i < Count; ++i)
+		{
+			const FVector Offset(-HalfExtent + (i % GridSize + 0.5f) * Spacing, -HalfExtent + (i / GridSize + 0.5f) * Spacing, 0.0f);
+			if (AActor* Actor = World->SpawnActor<AActor>(ActiveRun->CharacterClass, Center + Offset, FRotator::ZeroRotator, SpawnParameters))
+			{
+				ActiveRun->Spawned.Add(Actor);
+			}
+		}
+	}
+
+	static void StartPhase(EPhase Phase)
+	{
+		ActiveRun->Phase = Phase;
+		ActiveRun->FrameInPhase = 0;
+		ActiveRun->MeasuredSeconds = 0.0;
+	}
+
+	static void OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+	{
+		if (ActiveRun.IsValid() && World == ActiveRun->World.Get())
+		{
+			ActiveRun->TickStartTime = FPlatformTime::Seconds();
+		}
+	}
+
+	static void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+	{
+		if (!ActiveRun.IsValid() || World != ActiveRun->World.Get())
+		{
+			return;
+		}
+
+		FRun& Run = *ActiveRun;
+		Run.MeasuredSeconds += FPlatformTime::Seconds() - Run.TickStartTime;
+		++Run.FrameInPhase;
+
+		switch (Run.Phase)
+		{
+		case EPhase::WarmupScheduled:
+			if (Run.FrameInPhase >= WarmupFrames)
+			{
+				StartPhase(EPhase::MeasureScheduled);
+			}
+			break;
+		case EPhase::MeasureScheduled:
+			if (Run.FrameInPhase >= Run.Frames)
+			{
+				Run.ScheduledMilliseconds = Run.MeasuredSeconds * 1000.0 / Run.Frames;
+				SetSchedulingEnabled(false);
+				StartPhase(EPhase::WarmupUnscheduled);
+			}
+			break;
+		case EPhase::WarmupUnscheduled:
+			if (Run.FrameInPhase >= WarmupFrames)
+			{
+				StartPhase(EPhase::MeasureUnscheduled);
+			}
+			break;
+		case EPhase::MeasureUnscheduled:
+			if (Run.FrameInPhase >= Run.Frames)
+			{
+				const double UnscheduledMilliseconds = Run.MeasuredSeconds * 1000.0 / Run.Frames;
+				UE_LOG(LogAura, Display, TEXT("Aura.Significance.Benchmark %d enemies x %d frames: world tick %.3f ms scheduled, %.3f ms unscheduled"),
+					Run.Spawned.Num(), Run.Frames, Run.ScheduledMilliseconds, UnscheduledMilliseconds);
+
+				DestroySpawned();
+				if (++Run.CountIndex >= Run.Counts.Num())
+				{
+					Finish();
+					return;
+				}
+				SetSchedulingEnabled(true);
+				SpawnCurrentCount(World);
+				StartPhase(EPhase::WarmupScheduled);
+			}
+			break;
+		}
+	}
+
+	static void Start(const TArray<FString>& Args, UWorld* World)
+	{
+		if (World == nullptr || !World->IsGameWorld())
+		{
+			UE_LOG(LogAura, Warning, TEXT("Aura.Significance.Benchmark 需要在游戏世界中运行"));
+			return;
+		}
+		Finish();
+
+		ActiveRun = MakeUnique<FRun>();
+		ActiveRun->World = World;
+		ActiveRun->CharacterClass = AAuraEnemyCharacter::StaticClass();
+		ActiveRun->bOriginalEnabled = CVarAuraSignificanceEnabled.GetValueOnGameThread();
+		static const int32 DefaultCounts[] = { 100, 500, 1000 };
+		AuraBenchmarkUtils::ParseCounts(Args, DefaultCounts, ActiveRun->Counts, TEXT("Frames="), ActiveRun->Frames);
+		for (const FString& Arg : Args)
+		{
+			FString ClassPath;
+			if (FParse::Value(*Arg, TEXT("Class="), ClassPath))
+			{
+				if (UClass* Class = LoadClass<AAuraCharacterBase>(nullptr, *ClassPath))
+				{
+					ActiveRun->CharacterClass = Class;
+				}
+				else
+				{
+					UE_LOG(LogAura, Warning, TEXT("Aura.Significance.Benchmark 找不到角色类 %s，使用AAuraEnemyCharacter"), *ClassPath);
+				}
+			}
+		}
+
+		ActiveRun->TickStartHandle = FWorldDelegates::OnWorldTickStart.AddStatic(&OnWorldTickStart);
+		ActiveRun->PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddStatic(&OnWorldPostActorTick);
+		SetSchedulingEnabled(true);
+		SpawnCurrentCount(World);
+		StartPhase(EPhase::WarmupScheduled);
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CCmdAuraSignificanceBenchmark(
+	TEXT("Aura.Significance.Benchmark"),
+	TEXT("比较不同敌人数量下开启和关闭重要性调度时的世界Tick耗时。参数：[敌人数量...] [Frames=N] [Class=敌人类路径]，默认100、500、1000个敌人各300帧"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&AuraSignificanceBenchmark::Start));
+#endif
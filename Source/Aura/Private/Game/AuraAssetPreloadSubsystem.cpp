@@ -0,0 +1,130 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Game/AuraAssetPreloadSubsystem.h"
+
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "Engine/World.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Assets Preload Requested"), STAT_AuraAssetsPreloadRequested, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Assets Loaded Synchronously"), STAT_AuraAssetsLoadedSynchronously, STATGROUP_Aura);
+
+int32 UAuraAssetPreloadSubsystem::SynchronousLoadCount = 0;
+
+void UAuraAssetPreloadSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	InitializeTime = FPlatformTime::Seconds();
+	InitialSynchronousLoads = SynchronousLoadCount;
+	if (GetWorld()->IsGameWorld())
+	{
+		FirstTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UAuraAssetPreloadSubsystem::OnFirstPostActorTick);
+	}
+
+	TArray<FSoftObjectPath> Paths;
+	for (const FSoftClassPath& ClassPath : PreloadClasses)
+	{
+		Paths.Add(ClassPath);
+	}
+	if (!IsRunningDedicatedServer())
+	{
+		for (const FSoftClassPath& ClassPath : ClientPreloadClasses)
+		{
+			Paths.Add(ClassPath);
+		}
+	}
+	RequestPreload(Paths);
+}
+
+void UAuraAssetPreloadSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(FirstTickHandle);
+	FirstTickHandle.Reset();
+
+	for (const TSharedPtr<FStreamableHandle>& Handle : PreloadHandles)
+	{
+		if (Handle.IsValid())
+		{
+			Handle->ReleaseHandle();
+		}
+	}
+	PreloadHandles.Reset();
+	RequestedPaths.Reset();
+
+	Super::Deinitialize();
+}
+
+void UAuraAssetPreloadSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	BeginPlaySeconds = FPlatformTime::Seconds() - InitializeTime;
+}
+
+void UAuraAssetPreloadSubsystem::OnFirstPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld())
+	{
+		return;
+	}
+	FWorldDelegates::OnWorldPostActorTick.Remove(FirstTickHandle);
+	FirstTickHandle.Reset();
+
+	int32 NumCompleted = 0;
+	for (const TSharedPtr<FStreamableHandle>& Handle : PreloadHandles)
+	{
+		NumCompleted += Handle.IsValid() && Handle->HasLoadCompleted() ? 1 : 0;
+	}
+	UE_LOG(LogAura, Display, TEXT("Aura.AssetPreload %s: begin play %.1f ms, first frame %.1f ms after world init; %d/%d preload requests complete, %d synchronous loads"),
+		*World->GetMapName(), BeginPlaySeconds * 1000.0, (FPlatformTime::Seconds() - InitializeTime) * 1000.0,
+		NumCompleted, PreloadHandles.Num(), SynchronousLoadCount - InitialSynchronousLoads);
+}
+
+void UAuraAssetPreloadSubsystem::NotifySynchronousLoad(const FSoftObjectPath& Path)
+{
+	++SynchronousLoadCount;
+	INC_DWORD_STAT(STAT_AuraAssetsLoadedSynchronously);
+	UE_LOG(LogAura, Warning, TEXT("%s 没有预加载完成，改为同步加载，请检查预加载配置"), *Path.ToString());
+}
+
+void UAuraAssetPreloadSubsystem::RequestPreload(TConstArrayView<FSoftObjectPath> Paths)
+{
+	TArray<FSoftObjectPath> NewPaths;
+	for (const FSoftObjectPath& Path : Paths)
+	{
+		bool bAlreadyRequested = false;
+		if (!Path.IsNull())
+		{
+			RequestedPaths.Add(Path, &bAlreadyRequested);
+			if (!bAlreadyRequested)
+			{
+				NewPaths.Add(Path);
+			}
+		}
+	}
+	if (NewPaths.Num() == 0)
+	{
+		return;
+	}
+
+	INC_DWORD_STAT_BY(STAT_AuraAssetsPreloadRequested, NewPaths.Num());
+
+	// 句柄保存到世界销毁，保证预加载的类不会在使用前被GC
+	TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		MoveTemp(NewPaths), FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority);
+	if (Handle.IsValid())
+	{
+		PreloadHandles.Add(Handle);
+	}
+}
+
+void UAuraAssetPreloadSubsystem::RequestPreloadFor(const UObject* WorldContext, TConstArrayView<FSoftObjectPath> Paths)
+{
+	const UWorld* World = WorldContext ? WorldContext->GetWorld() : nullptr;
+	if (UAuraAssetPreloadSubsystem* PreloadSubsystem = World ? World->GetSubsystem<UAuraAssetPreloadSubsystem>() : nullptr)
+	{
+		PreloadSubsystem->RequestPreload(Paths);
+	}
+}
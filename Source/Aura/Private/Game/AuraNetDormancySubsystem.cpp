@@ -0,0 +1,127 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Game/AuraNetDormancySubsystem.h"
+
+#include "Aura/Aura.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Net Dormancy Update"), STAT_AuraNetDormancyUpdate, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Dormant Actors"), STAT_AuraDormantActors, STATGROUP_Aura);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Dormancy Managed Actors"), STAT_AuraDormancyManagedActors, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dormancy Wakeups"), STAT_AuraDormancyWakeups, STATGROUP_Aura);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Net Update Checks Avoided By Dormancy"), STAT_AuraDormancyNetChecksAvoided, STATGROUP_Aura);
+
+void UAuraNetDormancySubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	SCOPE_CYCLE_COUNTER(STAT_AuraNetDormancyUpdate);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	const float MovementToleranceSquared = FMath::Square(MovementTolerance);
+	int32 NumDormant = 0;
+	float NetChecksAvoided = 0.0f;
+
+	for (auto It = ManagedActors.CreateIterator(); It; ++It)
+	{
+		AActor* Actor = It->Key.Get();
+		if (Actor == nullptr)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		FDormancyEntry& Entry = It->Value;
+		const FVector Location = Actor->GetActorLocation();
+		if (FVector::DistSquared(Location, Entry.LastLocation) > MovementToleranceSquared)
+		{
+			// 移动了：休眠中就唤醒，让新位置在这一帧的网络更新中发出去
+			Entry.LastLocation = Location;
+			Entry.LastActivityTime = Now;
+			if (Entry.bDormant)
+			{
+				WakeActor(Actor, Entry);
+			}
+		}
+		else if (!Entry.bDormant && Now - Entry.LastActivityTime >= QuietPeriod)
+		{
+			Actor->SetNetDormancy(DORM_DormantAll);
+			Entry.bDormant = true;
+		}
+
+		if (Entry.bDormant)
+		{
+			// 估算：休眠的Actor本来每秒要被考虑NetUpdateFrequency次
+			++NumDormant;
+			NetChecksAvoided += Actor->NetUpdateFrequency * DeltaTime;
+		}
+	}
+
+	SET_DWORD_STAT(STAT_AuraDormantActors, NumDormant);
+	SET_DWORD_STAT(STAT_AuraDormancyManagedActors, ManagedActors.Num());
+	INC_FLOAT_STAT_BY(STAT_AuraDormancyNetChecksAvoided, NetChecksAvoided);
+}
+
+TStatId UAuraNetDormancySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAuraNetDormancySubsystem, STATGROUP_Tickables);
+}
+
+void UAuraNetDormancySubsystem::RegisterActor(AActor* Actor)
+{
+	if (Actor == nullptr || !Actor->HasAuthority() || Actor->GetNetMode() == NM_Standalone)
+	{
+		return;
+	}
+
+	FDormancyEntry& Entry = ManagedActors.FindOrAdd(Actor);
+	Entry.LastLocation = Actor->GetActorLocation();
+	Entry.LastActivityTime = GetWorld()->GetTimeSeconds();
+	Entry.bDormant = Actor->NetDormancy > DORM_Awake;
+}
+
+void UAuraNetDormancySubsystem::UnregisterActor(AActor* Actor)
+{
+	ManagedActors.Remove(Actor);
+}
+
+void UAuraNetDormancySubsystem::NotifyActivity(AActor* Actor)
+{
+	FDormancyEntry* Entry = ManagedActors.Find(Actor);
+	if (Entry == nullptr)
+	{
+		return;
+	}
+
+	Entry->LastActivityTime = GetWorld()->GetTimeSeconds();
+	if (Entry->bDormant)
+	{
+		WakeActor(Actor, *Entry);
+	}
+}
+
+void UAuraNetDormancySubsystem::NotifyActorActivity(AActor* Actor)
+{
+	if (Actor == nullptr || !Actor->HasAuthority())
+	{
+		return;
+	}
+
+	if (const UWorld* World = Actor->GetWorld())
+	{
+		if (UAuraNetDormancySubsystem* DormancySubsystem = World->GetSubsystem<UAuraNetDormancySubsystem>())
+		{
+			DormancySubsystem->NotifyActivity(Actor);
+		}
+	}
+}
+
+void UAuraNetDormancySubsystem::WakeActor(AActor* Actor, FDormancyEntry& Entry)
+{
+	// FlushNetDormancy让休眠期间的修改在下一次网络更新中发送，再设为Awake避免马上又被判定为休眠
+	Actor->FlushNetDormancy();
+	Actor->SetNetDormancy(DORM_Awake);
+	Entry.bDormant = false;
+	INC_DWORD_STAT(STAT_AuraDormancyWakeups);
+}
@@ -0,0 +1,194 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Game/AuraReplicationGraph.h"
+
+#include "Actor/AuraEffectActor.h"
+#include "Character/AuraCharacter.h"
+#include "Character/AuraEnemyCharacter.h"
+#include "Engine/LevelScriptActor.h"
+#include "Engine/NetDriver.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Player/AuraPlayerState.h"
+
+void UAuraReplicationGraphNode_OwnerOnly::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	// 父类负责收集连接的PlayerController、Pawn、ViewTarget
+	Super::GatherActorListsForConnection(Params);
+
+	OwnedActorList.Reset();
+	for (const FNetViewer& Viewer : Params.Viewers)
+	{
+		if (const APlayerController* PlayerController = Cast<APlayerController>(Viewer.InViewer))
+		{
+			if (APlayerState* PlayerState = PlayerController->PlayerState)
+			{
+				OwnedActorList.ConditionalAdd(PlayerState);
+			}
+		}
+	}
+
+	if (OwnedActorList.Num() > 0)
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList(OwnedActorList);
+	}
+}
+
+UAuraReplicationGraph::UAuraReplicationGraph()
+{
+	ReplicationConnectionManagerClass = UNetReplicationGraphConnection::StaticClass();
+}
+
+void UAuraReplicationGraph::ResetGameWorldState()
+{
+	Super::ResetGameWorldState();
+
+	// 切换地图时清空始终相关列表里上一张地图的Actor
+	if (AlwaysRelevantNode)
+	{
+		AlwaysRelevantNode->NotifyResetAllNetworkActors();
+	}
+}
+
+void UAuraReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	// 项目里的主要复制Actor显式设置路由方式
+	ClassRepNodePolicies.Set(AAuraEnemyCharacter::StaticClass(), EAuraClassRepNodeMapping::Spatialize_Dynamic);
+	ClassRepNodePolicies.Set(AAuraCharacter::StaticClass(), EAuraClassRepNodeMapping::Spatialize_Dynamic);
+	ClassRepNodePolicies.Set(AAuraEffectActor::StaticClass(), EAuraClassRepNodeMapping::Spatialize_Dormancy);
+	ClassRepNodePolicies.Set(APlayerState::StaticClass(), EAuraClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(APlayerController::StaticClass(), EAuraClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(AGameStateBase::StaticClass(), EAuraClassRepNodeMapping::RelevantAllConnections);
+	ClassRepNodePolicies.Set(ALevelScriptActor::StaticClass(), EAuraClassRepNodeMapping::NotRouted);
+
+	// 距离优先级：敌人和效果Actor离得越远越晚复制，玩家角色稍微更重要一些
+	InitClassReplicationInfo(AAuraEnemyCharacter::StaticClass(), 1.0f);
+	InitClassReplicationInfo(AAuraEffectActor::StaticClass(), 1.0f);
+	InitClassReplicationInfo(AAuraCharacter::StaticClass(), 0.5f);
+	InitClassReplicationInfo(AAuraPlayerState::StaticClass(), 0.0f);
+}
+
+void UAuraReplicationGraph::InitClassReplicationInfo(UClass* Class, float DistancePriorityScale)
+{
+	const AActor* CDO = Class->GetDefaultObject<AActor>();
+
+	FClassReplicationInfo ClassInfo;
+	ClassInfo.DistancePriorityScale = DistancePriorityScale;
+	ClassInfo.StarvationPriorityScale = 1.0f;
+	ClassInfo.SetCullDistanceSquared(CDO->NetCullDistanceSquared);
+	ClassInfo.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(CDO->NetUpdateFrequency);
+	GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+}
+
+void UAuraReplicationGraph::SetActorReplicationFrequency(AActor* Actor, float NetUpdateFrequency)
+{
+	const UNetDriver* NetDriver = Actor ? Actor->GetNetDriver() : nullptr;
+	UAuraReplicationGraph* Graph = NetDriver ? Cast<UAuraReplicationGraph>(NetDriver->GetReplicationDriver()) : nullptr;
+	if (Graph == nullptr)
+	{
+		return;
+	}
+
+	// 只改这个Actor的设置，同类的其他Actor仍然使用类的设置
+	FGlobalActorReplicationInfo& GlobalInfo = Graph->GlobalActorReplicationInfoMap.FindOrAdd(Actor);
+	GlobalInfo.Settings.ReplicationPeriodFrame = Graph->GetReplicationPeriodFrameForFrequency(NetUpdateFrequency);
+}
+
+void UAuraReplicationGraph::InitGlobalGraphNodes()
+{
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode->CellSize = GridCellSize;
+	GridNode->SpatialBias = SpatialBias;
+	AddGlobalGraphNode(GridNode);
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+
+	// PlayerState对所有连接相关，但每帧只复制一部分，避免玩家多时PlayerState占满带宽
+	UReplicationGraphNode_PlayerStateFrequencyLimiter* PlayerStateNode = CreateNewNode<UReplicationGraphNode_PlayerStateFrequencyLimiter>();
+	AddGlobalGraphNode(PlayerStateNode);
+}
+
+void UAuraReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	UAuraReplicationGraphNode_OwnerOnly* OwnerOnlyNode = CreateNewNode<UAuraReplicationGraphNode_OwnerOnly>();
+	AddConnectionGraphNode(OwnerOnlyNode, RepGraphConnection);
+}
+
+EAuraClassRepNodeMapping UAuraReplicationGraph::GetMappingPolicy(UClass* Class)
+{
+	if (const EAuraClassRepNodeMapping* Policy = ClassRepNodePolicies.Get(Class))
+	{
+		return *Policy;
+	}
+
+	// 没有显式设置的类按CDO的属性推断：始终相关、只对拥有者相关、能否移动
+	const AActor* CDO = Class->GetDefaultObject<AActor>();
+	EAuraClassRepNodeMapping Policy;
+	if (CDO->bAlwaysRelevant)
+	{
+		Policy = EAuraClassRepNodeMapping::RelevantAllConnections;
+	}
+	else if (CDO->bOnlyRelevantToOwner)
+	{
+		Policy = EAuraClassRepNodeMapping::NotRouted;
+	}
+	else if (CDO->GetRootComponent() && CDO->GetRootComponent()->Mobility == EComponentMobility::Movable)
+	{
+		Policy = EAuraClassRepNodeMapping::Spatialize_Dynamic;
+	}
+	else
+	{
+		Policy = EAuraClassRepNodeMapping::Spatialize_Static;
+	}
+	ClassRepNodePolicies.Set(Class, Policy);
+	return Policy;
+}
+
+void UAuraReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EAuraClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+		break;
+	case EAuraClassRepNodeMapping::Spatialize_Static:
+		GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+		break;
+	case EAuraClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+		break;
+	case EAuraClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+		break;
+	default:
+		break;
+	}
+}
+
+void UAuraReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EAuraClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+		break;
+	case EAuraClassRepNodeMapping::Spatialize_Static:
+		GridNode->RemoveActor_Static(ActorInfo);
+		break;
+	case EAuraClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->RemoveActor_Dynamic(ActorInfo);
+		break;
+	case EAuraClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->RemoveActor_Dormancy(ActorInfo);
+		break;
+	default:
+		break;
+	}
+}
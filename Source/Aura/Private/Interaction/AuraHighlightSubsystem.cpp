@@ -0,0 +1,158 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Interaction/AuraHighlightSubsystem.h"
+
+#include "Aura/Aura.h"
+#include "Engine/OverlapResult.h"
+#include "Engine/World.h"
+#include "Interaction/EnemyInterface.h"
+
+DECLARE_CYCLE_STAT(TEXT("Highlight Commit"), STAT_AuraHighlightCommit, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Highlight Render State Updates"), STAT_AuraHighlightRenderStateUpdates, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Highlight Toggles Coalesced"), STAT_AuraHighlightTogglesCoalesced, STATGROUP_Aura);
+
+bool UAuraHighlightSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UAuraHighlightSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (PendingActors.Num() > 0)
+	{
+		CommitHighlightChanges();
+	}
+}
+
+TStatId UAuraHighlightSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAuraHighlightSubsystem, STATGROUP_Tickables);
+}
+
+void UAuraHighlightSubsystem::AddHighlightSource(AActor* Actor, EAuraHighlightSource Source)
+{
+	SetSourceBit(Actor, Source, true);
+}
+
+void UAuraHighlightSubsystem::RemoveHighlightSource(AActor* Actor, EAuraHighlightSource Source)
+{
+	SetSourceBit(Actor, Source, false);
+}
+
+void UAuraHighlightSubsystem::SetHighlightSourceActors(EAuraHighlightSource Source, const TArray<AActor*>& Actors)
+{
+	const uint8 Bit = 1 << (uint8)Source;
+
+	// 先移除不在新集合中的Actor的该来源，再给新集合中的Actor加上该来源
+	TSet<AActor*> NewActors(Actors);
+	for (auto& Pair : HighlightStates)
+	{
+		if ((Pair.Value.SourceMask & Bit) && !NewActors.Contains(Pair.Key.Get()))
+		{
+			Pair.Value.SourceMask &= ~Bit;
+			PendingActors.Add(Pair.Key);
+		}
+	}
+	for (AActor* Actor : NewActors)
+	{
+		SetSourceBit(Actor, Source, true);
+	}
+}
+
+void UAuraHighlightSubsystem::SetAreaHover(const FVector& Center, float Radius)
+{
+	TArray<AActor*> Actors;
+	if (Radius > 0.0f)
+	{
+		TArray<FOverlapResult> Overlaps;
+		GetWorld()->OverlapMultiByObjectType(Overlaps, Center, FQuat::Identity,
+			FCollisionObjectQueryParams(ECC_Pawn), FCollisionShape::MakeSphere(Radius),
+			FCollisionQueryParams(SCENE_QUERY_STAT(AuraAreaHover), false));
+
+		for (const FOverlapResult& Overlap : Overlaps)
+		{
+			AActor* Actor = Overlap.GetActor();
+			if (Actor && Cast<IEnemyInterface>(Actor))
+			{
+				Actors.AddUnique(Actor);
+			}
+		}
+	}
+	SetHighlightSourceActors(EAuraHighlightSource::Area, Actors);
+}
+
+bool UAuraHighlightSubsystem::IsHighlightRequested(const AActor* Actor) const
+{
+	const FHighlightState* State = HighlightStates.Find(Actor);
+	return State && State->SourceMask != 0;
+}
+
+void UAuraHighlightSubsystem::SetSourceBit(AActor* Actor, EAuraHighlightSource Source, bool bEnabled)
+{
+	if (Actor == nullptr)
+	{
+		return;
+	}
+
+	const uint8 Bit = 1 << (uint8)Source;
+	if (bEnabled)
+	{
+		HighlightStates.FindOrAdd(Actor).SourceMask |= Bit;
+	}
+	else if (FHighlightState* State = HighlightStates.Find(Actor))
+	{
+		State->SourceMask &= ~Bit;
+	}
+	else
+	{
+		return;
+	}
+	PendingActors.Add(Actor);
+}
+
+/**
+ * 统一提交：只处理本帧变化过的Actor，期望状态和已提交状态相同的直接跳过（同一帧内来回切换的情况）
+ * 不再需要高亮且已经取消高亮的Actor从表中移除，表的大小只和当前高亮的敌人数量相关
+ */
+void UAuraHighlightSubsystem::CommitHighlightChanges()
+{
+	SCOPE_CYCLE_COUNTER(STAT_AuraHighlightCommit);
+
+	for (const TWeakObjectPtr<AActor>& WeakActor : PendingActors)
+	{
+		FHighlightState* State = HighlightStates.Find(WeakActor);
+		if (State == nullptr)
+		{
+			continue;
+		}
+
+		AActor* Actor = WeakActor.Get();
+		IEnemyInterface* Enemy = Cast<IEnemyInterface>(Actor);
+		if (Enemy == nullptr)
+		{
+			HighlightStates.Remove(WeakActor);
+			continue;
+		}
+
+		const bool bWantHighlight = State->SourceMask != 0;
+		if (bWantHighlight != State->bCommitted)
+		{
+			Enemy->ApplyHighlightRenderState(bWantHighlight);
+			State->bCommitted = bWantHighlight;
+			INC_DWORD_STAT(STAT_AuraHighlightRenderStateUpdates);
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_AuraHighlightTogglesCoalesced);
+		}
+
+		if (!bWantHighlight)
+		{
+			HighlightStates.Remove(WeakActor);
+		}
+	}
+	PendingActors.Reset();
+}
@@ -5,7 +5,10 @@
 #include "InputAction.h"
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
+#include "GameFramework/Pawn.h"
+#include "Character/AuraEnemyCharacter.h"
 #include "Interaction/EnemyInterface.h"
+#include "Player/AuraTargetingSubsystem.h"
 
 AAuraPlayerController::AAuraPlayerController()
 {
@@ -23,20 +26,26 @@ void AAuraPlayerController::CursorTrace()
 {
 	//需要检测当前鼠标下的actor
 	
-	//储存这一次检测的结果
-	FHitResult CursorResults;
+	//鼠标下的检测由目标检测子系统统一执行，每帧最多一次，技能和UI也使用同一个结果
+	UAuraTargetingSubsystem* TargetingSubsystem = ULocalPlayer::GetSubsystem<UAuraTargetingSubsystem>(GetLocalPlayer());
+	if (TargetingSubsystem == nullptr) return;
 	
-	// 检测鼠标光标正下方的碰撞对象，获取碰撞结果
-	// 参数1：ECC_Visibility - 碰撞通道类型为"可见性通道"（仅检测设置了"可见性"碰撞响应的对象，常用于UI交互、选中检测等场景）
-	// 参数2：false - 是否忽略复杂碰撞体（false表示不忽略，会检测复杂网格体的精确碰撞；true则只检测简化碰撞体，性能更高）
-	// 参数3：CursorResults - 输出参数（FHitResult或TArray<FHitResult>类型），用于存储碰撞检测到的结果（如命中的Actor、碰撞位置、法线等信息）
-	GetHitResultUnderCursor(ECC_Visibility, false, CursorResults);
+	const FAuraCursorTarget& CursorTarget = TargetingSubsystem->GetCursorTarget();
 	
-	if (!CursorResults.GetActor()) return;
+	//本帧没有新的检测结果（悬停缓存有效或异步结果未就绪）时，鼠标下的目标和上一帧一样，高亮状态也不需要变化
+	if (!TargetingSubsystem->WasRefreshedThisFrame()) return;
+	
+	//没有命中任何Actor时ThisActor为空，按情况3取消上一帧的高亮（不能直接返回，否则上一个敌人会一直保持高亮）
 	
 	//当这个函数调用的时候当前thisActor中的就是上一帧的actor
 	LastActor = ThisActor;
-	ThisActor = Cast<IEnemyInterface>(CursorResults.GetActor());
+	ThisActor = CursorTarget.Enemy.Get();
+	
+	//悬停的敌人发生变化时通知服务器
+	if (ThisActor != LastActor)
+	{
+		ServerSetHoveredEnemy(ThisActor ? CursorTarget.HitActor.Get() : nullptr);
+	}
 	/*
 	 * 这次的射线检测有以下几个结果
 	 *1. last和this都为空，代表玩家前后两帧鼠标下都没有任何敌方actor
@@ -87,6 +96,40 @@ void AAuraPlayerController::CursorTrace()
 	}
 	
 }
+void AAuraPlayerController::ServerSetHoveredEnemy_Implementation(AActor* Enemy)
+{
+	// 客户端可以上报任意Actor，不可信的当作没有悬停，不会为它创建能力系统或提高复制频率
+	if (Enemy && !IsValidHoveredEnemy(Enemy))
+	{
+		Enemy = nullptr;
+	}
+	HoveredEnemy = Enemy;
+
+	// 被悬停的敌人马上就可能成为目标，延迟创建模式下在这里创建它的能力系统
+	if (AAuraEnemyCharacter* AuraEnemy = Cast<AAuraEnemyCharacter>(Enemy))
+	{
+		AuraEnemy->ActivateAbilitySystem();
+	}
+}
+
+bool AAuraPlayerController::IsValidHoveredEnemy(const AActor* Enemy) const
+{
+	const APawn* ControlledPawn = GetPawn();
+	if (!IsValid(Enemy) || !Enemy->Implements<UEnemyInterface>() || ControlledPawn == nullptr)
+	{
+		return false;
+	}
+	if (FVector::DistSquared(Enemy->GetActorLocation(), ControlledPawn->GetActorLocation()) > FMath::Square(MaxHoveredEnemyDistance))
+	{
+		return false;
+	}
+	
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	GetPlayerViewPoint(ViewLocation, ViewRotation);
+	return Enemy->IsNetRelevantFor(this, GetViewTarget(), ViewLocation);
+}
+
 void AAuraPlayerController::BeginPlay()
 {
 	Super::BeginPlay();
@@ -5,6 +5,10 @@
 
 #include "AbilitySystem/AuraAbilitySystemComponent.h"
 #include "AbilitySystem/AuraAttributeSet.h"
+#include "AbilitySystem/AuraDerivedAttributeSubsystem.h"
+#include "Game/AuraReplicationGraph.h"
+#include "GameplayEffect.h"
+#include "TimerManager.h"
 
 AAuraPlayerState::AAuraPlayerState()
 {
@@ -33,9 +37,110 @@ AAuraPlayerState::AAuraPlayerState()
 	// 2. 数值越高，同步越实时（如高速移动的角色、快节奏战斗的敌人），但会占用更多网络带宽；数值越低，带宽占用越少，但同步延迟可能增加
 	// 3. 适用场景：常用于需要精准同步状态的Actor（如玩家角色、核心战斗单位），非关键Actor（如场景道具）可适当降低（如10-30Hz）以节省带宽
 	// 4. 依赖Actor的bReplicates=true（可复制）属性生效，若bReplicates=false，该频率设置无效
+	// 5. 这里是有复制活动时的频率，空闲时降到IdleNetUpdateFrequency（见NotifyReplicationActivity）
 	NetUpdateFrequency = 100.0f;
+	MinNetUpdateFrequency = 2.0f;
+}
 
-	
+void AAuraPlayerState::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (HasAuthority())
+	{
+		AbilitySystemComponent->OnActiveGameplayEffectAddedDelegateToSelf.AddUObject(this, &AAuraPlayerState::OnActiveGameplayEffectAdded);
+		AbilitySystemComponent->OnAnyGameplayEffectRemovedDelegate().AddUObject(this, &AAuraPlayerState::OnActiveGameplayEffectRemoved);
+		NotifyReplicationActivity();
+	}
+}
+
+void AAuraPlayerState::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (HasAuthority())
+	{
+		AbilitySystemComponent->OnActiveGameplayEffectAddedDelegateToSelf.RemoveAll(this);
+		AbilitySystemComponent->OnAnyGameplayEffectRemovedDelegate().RemoveAll(this);
+		GetWorldTimerManager().ClearTimer(IdleTimerHandle);
+
+		// 玩家的能力系统组件在角色初始化属性时注册推导，跟随PlayerState一起注销
+		if (UAuraDerivedAttributeSubsystem* DerivedSubsystem = GetWorld()->GetSubsystem<UAuraDerivedAttributeSubsystem>())
+		{
+			DerivedSubsystem->UnregisterAbilitySystem(AbilitySystemComponent);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+/**
+ * 属性变化、效果添加/移除时调用：恢复高频更新，立即发送一次，并重新开始空闲计时
+ * 空闲时每次属性变化都会先唤醒/提频，再ForceNetUpdate，保证变化不会等到下一个低频更新周期才发送
+ */
+void AAuraPlayerState::NotifyReplicationActivity()
+{
+	if (!HasAuthority() || !HasActorBegunPlay())
+	{
+		return;
+	}
+
+	if (bReplicationIdle)
+	{
+		bReplicationIdle = false;
+		SetReplicationFrequency(ActiveNetUpdateFrequency);
+		if (NetDormancy > DORM_Awake)
+		{
+			SetNetDormancy(DORM_Awake);
+		}
+	}
+	ForceNetUpdate();
+
+	GetWorldTimerManager().SetTimer(IdleTimerHandle, this, &AAuraPlayerState::OnIdleTimerElapsed, IdleDelay, false);
+}
+
+void AAuraPlayerState::OnIdleTimerElapsed()
+{
+	// 还有持续中的效果：效果结束时属性会变化，继续保持高频
+	if (HasActiveDurationEffects())
+	{
+		GetWorldTimerManager().SetTimer(IdleTimerHandle, this, &AAuraPlayerState::OnIdleTimerElapsed, IdleDelay, false);
+		return;
+	}
+
+	bReplicationIdle = true;
+	SetReplicationFrequency(IdleNetUpdateFrequency);
+	if (bDormantWhenIdle)
+	{
+		SetNetDormancy(DORM_DormantAll);
+	}
+}
+
+void AAuraPlayerState::SetReplicationFrequency(float Frequency)
+{
+	// 默认的复制路径每次都读取NetUpdateFrequency；复制图只在加入时读取一次类的设置，需要同时写入复制图
+	NetUpdateFrequency = Frequency;
+	UAuraReplicationGraph::SetActorReplicationFrequency(this, Frequency);
+}
+
+void AAuraPlayerState::OnActiveGameplayEffectAdded(UAbilitySystemComponent* Target, const FGameplayEffectSpec& Spec, FActiveGameplayEffectHandle Handle)
+{
+	NotifyReplicationActivity();
+}
+
+void AAuraPlayerState::OnActiveGameplayEffectRemoved(const FActiveGameplayEffect& Effect)
+{
+	NotifyReplicationActivity();
+}
+
+bool AAuraPlayerState::HasActiveDurationEffects() const
+{
+	for (const FActiveGameplayEffect& Effect : &AbilitySystemComponent->GetActiveGameplayEffects())
+	{
+		if (Effect.GetDuration() > 0.0f)
+		{
+			return true;
+		}
+	}
+	return false;
 }
 
 UAbilitySystemComponent* AAuraPlayerState::GetAbilitySystemComponent() const
@@ -0,0 +1,163 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Player/AuraTargetingSubsystem.h"
+
+#include "Aura/Aura.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Interaction/EnemyInterface.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cursor Traces"), STAT_AuraCursorTraces, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cursor Traces Skipped"), STAT_AuraCursorTracesSkipped, STATGROUP_Aura);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Cursor Trace Skip Rate"), STAT_AuraCursorTraceSkipRate, STATGROUP_Aura);
+
+const FAuraCursorTarget& UAuraTargetingSubsystem::GetCursorTarget()
+{
+	if (LastUpdateFrame != GFrameCounter)
+	{
+		LastUpdateFrame = GFrameCounter;
+		UpdateCursorTarget();
+	}
+	return CursorTarget;
+}
+
+void UAuraTargetingSubsystem::UpdateCursorTarget()
+{
+	APlayerController* PlayerController = GetLocalPlayer() ? GetLocalPlayer()->PlayerController : nullptr;
+	if (PlayerController == nullptr || PlayerController->GetWorld() == nullptr)
+	{
+		return;
+	}
+
+	//悬停缓存有效并且没有等待中的异步射线时，鼠标下的结果和上一次一样
+	++NumCursorTraceFrames;
+	const bool bHoverCacheValid = IsCursorHoverCacheValid(PlayerController);
+	const bool bSkipTrace = bHoverCacheValid && !PendingCursorTraceHandle.IsValid();
+	if (bSkipTrace)
+	{
+		++NumCursorTraceSkips;
+		INC_DWORD_STAT(STAT_AuraCursorTracesSkipped);
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_AuraCursorTraces);
+	}
+	SET_FLOAT_STAT(STAT_AuraCursorTraceSkipRate, static_cast<float>(NumCursorTraceSkips) / NumCursorTraceFrames);
+	if (bSkipTrace)
+	{
+		return;
+	}
+
+	//异步模式下结果还没有准备好时保持上一次的目标（鼠标离开视口时会得到空结果）
+	FHitResult HitResult;
+	if (!GetCursorHitResult(PlayerController, HitResult, !bHoverCacheValid))
+	{
+		return;
+	}
+
+	AActor* PreviousHitActor = CursorTarget.HitActor;
+
+	CursorTarget.HitResult = HitResult;
+	CursorTarget.HitActor = HitResult.GetActor();
+	CursorTarget.Location = HitResult.bBlockingHit ? FVector(HitResult.ImpactPoint) : FVector::ZeroVector;
+	CursorTarget.bBlockingHit = HitResult.bBlockingHit;
+	CursorTarget.Enemy = Cast<IEnemyInterface>(CursorTarget.HitActor);
+	LastRefreshFrame = GFrameCounter;
+
+	//记录命中Actor的位置，它移动后缓存失效
+	if (CursorTarget.HitActor)
+	{
+		CachedHitActorTransform = CursorTarget.HitActor->GetActorTransform();
+	}
+
+	if (PreviousHitActor != CursorTarget.HitActor)
+	{
+		OnCursorTargetChanged.Broadcast(CursorTarget);
+	}
+}
+
+bool UAuraTargetingSubsystem::IsCursorHoverCacheValid(APlayerController* PlayerController)
+{
+	float MouseX = 0.0f;
+	float MouseY = 0.0f;
+	const bool bHasMouse = PlayerController->GetMousePosition(MouseX, MouseY);
+	const FVector2D MousePosition(MouseX, MouseY);
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	const double Now = PlayerController->GetWorld()->GetTimeSeconds();
+
+	bool bValid = bUseCursorHoverCache && bHasMouse && bHasHoverCache
+		&& Now - CachedHoverTime < HoverCacheMaxAge
+		&& MousePosition.Equals(CachedMousePosition, 0.5f)
+		&& ViewLocation.Equals(CachedViewLocation, 0.1)
+		&& ViewRotation.Equals(CachedViewRotation, 0.01f);
+
+	//上一次命中的Actor被销毁或者移动了，鼠标下的物体可能已经不同
+	if (bValid && CursorTarget.HitActor != nullptr)
+	{
+		bValid = IsValid(CursorTarget.HitActor) && CursorTarget.HitActor->GetActorTransform().Equals(CachedHitActorTransform, 0.1);
+	}
+
+	if (!bValid)
+	{
+		bHasHoverCache = bHasMouse;
+		CachedMousePosition = MousePosition;
+		CachedViewLocation = ViewLocation;
+		CachedViewRotation = ViewRotation;
+		CachedHoverTime = Now;
+	}
+	return bValid;
+}
+
+bool UAuraTargetingSubsystem::GetCursorHitResult(APlayerController* PlayerController, FHitResult& OutHitResult, bool bIssueNewTrace)
+{
+	if (!bUseAsyncCursorTrace)
+	{
+		// 检测鼠标光标正下方的碰撞对象，获取碰撞结果
+		// 参数1：ECC_Visibility - 碰撞通道类型为"可见性通道"（仅检测设置了"可见性"碰撞响应的对象，常用于UI交互、选中检测等场景）
+		// 参数2：false - 是否忽略复杂碰撞体（false表示不忽略，会检测复杂网格体的精确碰撞；true则只检测简化碰撞体，性能更高）
+		// 参数3：OutHitResult - 输出参数，用于存储碰撞检测到的结果（如命中的Actor、碰撞位置、法线等信息）
+		PlayerController->GetHitResultUnderCursor(ECC_Visibility, false, OutHitResult);
+		return true;
+	}
+
+	UWorld* World = PlayerController->GetWorld();
+
+	// 1. 取回上一帧发起的异步射线结果（结果在上一帧末尾由异步检测批次完成）
+	bool bHasResult = false;
+	FTraceDatum TraceDatum;
+	if (PendingCursorTraceHandle.IsValid() && World->QueryTraceData(PendingCursorTraceHandle, TraceDatum))
+	{
+		OutHitResult = TraceDatum.OutHits.Num() > 0 ? TraceDatum.OutHits[0] : FHitResult();
+		bHasResult = true;
+	}
+
+	// 2. 为下一帧发起新的异步射线，参数和GetHitResultUnderCursor保持一致（可见性通道、简单碰撞、HitResultTraceDistance）
+	FVector WorldLocation;
+	FVector WorldDirection;
+	if (!bIssueNewTrace)
+	{
+		// 悬停缓存有效，下一帧不需要新的结果
+		PendingCursorTraceHandle = FTraceHandle();
+	}
+	else if (PlayerController->DeprojectMousePositionToWorld(WorldLocation, WorldDirection))
+	{
+		const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(AuraAsyncCursorTrace), false);
+		PendingCursorTraceHandle = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, WorldLocation,
+			WorldLocation + WorldDirection * PlayerController->HitResultTraceDistance, ECC_Visibility, QueryParams);
+	}
+	else
+	{
+		// 鼠标不在视口中，没有可检测的位置：发布一个空的结果，和同步模式一样取消上一个敌人的高亮
+		PendingCursorTraceHandle = FTraceHandle();
+		OutHitResult = FHitResult();
+		return true;
+	}
+
+	return bHasResult;
+}
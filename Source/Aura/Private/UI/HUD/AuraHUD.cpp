@@ -3,14 +3,29 @@
 
 #include "UI/HUD/AuraHUD.h"
 
+#include "Engine/LocalPlayer.h"
+#include "Game/AuraAssetPreloadSubsystem.h"
+#include "UI/HUD/AuraOverlaySubsystem.h"
 #include "UI/Widget/AuraUserWidget.h"
 #include "UI/WidgetController/AuraWidgetController.h"
 #include "UI/WidgetController/OverlayWidgetController.h"
 
 
+void AAuraHUD::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	const FSoftObjectPath Paths[] = {
+		OverlayWidgetClass.ToSoftObjectPath(),
+		OverlayWidgetControllerClass.ToSoftObjectPath(),
+	};
+	UAuraAssetPreloadSubsystem::RequestPreloadFor(this, Paths);
+}
+
 /**
  * 获取/创建Overlay UI对应的WidgetController（UI逻辑控制器）
  * 采用单例模式：仅当控制器为空时新建，避免重复创建，保证UI逻辑唯一
+ * 控制器保存在本地玩家的UAuraOverlaySubsystem中，重生和切换地图后新的HUD会拿到同一个控制器
  * @param PCparms 传递给WidgetController的核心参数（玩家控制器、状态、能力系统等）
  * @return 初始化完成的OverlayWidgetController（UI逻辑控制器）
  */
@@ -19,67 +34,129 @@ UOverlayWidgetController* AAuraHUD::GetOverlayWidgetController(const FWidgetCont
 	// 判空：仅当控制器未创建时，才新建实例（单例逻辑，避免重复创建）
 	if (OverlayWidgetController == nullptr)
 	{
-		// 新建OverlayWidgetController实例：
-		// this：指定HUD为该对象的Outer（所有者），保证内存管理安全；
+		// 从本地玩家的Overlay子系统取得（或新建）控制器实例：
 		// OverlayWidgetControllerClass：编辑器配置的蓝图模板，决定创建哪个子类实例
-		OverlayWidgetController = NewObject<UOverlayWidgetController>(this,OverlayWidgetControllerClass);
+		UAuraOverlaySubsystem* OverlaySubsystem = ULocalPlayer::GetSubsystem<UAuraOverlaySubsystem>(GetOwningPlayerController()->GetLocalPlayer());
+		const TSubclassOf<UOverlayWidgetController> ControllerClass = UAuraAssetPreloadSubsystem::ResolveClass(OverlayWidgetControllerClass);
+		OverlayWidgetController = OverlaySubsystem
+			? OverlaySubsystem->FindOrCreateOverlayWidgetController(ControllerClass)
+			: NewObject<UOverlayWidgetController>(this,ControllerClass);
+	}
+	// 参数不同（第一次创建，或者重生/切换地图后换了PlayerState、ASC）时才设置参数并重新绑定
+	if (!OverlayWidgetController->MatchesWidgetControllerParams(PCparms))
+	{
 		// 给控制器设置核心参数（玩家控制器、状态等），让控制器能访问游戏核心数据
 		OverlayWidgetController->SetWidgetControllerParams(PCparms);
-		//再将基础属性值变化的时候的对应绑定函数进行绑定
+		//再将基础属性值变化的时候的对应绑定函数进行绑定（会先解绑旧ASC上的回调）
 		OverlayWidgetController->BindCallbacksToDependencies();
-		return OverlayWidgetController;
 	}
-	// 控制器已存在，直接返回（避免重复初始化）
 	return OverlayWidgetController;
 }
 
 /**
  * 初始化HUD核心Overlay UI（血条/蓝条/属性面板等）
  * 核心逻辑：创建UI控件 → 初始化UI逻辑控制器 → 绑定控制器到UI → 显示UI
+ * 可以重复调用（服务器PossessedBy和客户端OnRep_PlayerState都会调用，PlayerState也可能重新复制）：
+ * UI控件只创建一次；参数没变时直接返回；参数变化时只重新绑定控制器并广播一次初始值
+ * 控件和控制器保存在UAuraOverlaySubsystem（本地玩家子系统）中，重生和无缝旅行后复用，不会重新构建控件树
+ * @param Requester 使用Overlay的对象，用于引用计数
  * @param PC 玩家控制器（提供输入/视角等上下文）
  * @param PS 玩家状态（存储玩家等级/血量等持久化数据）
  * @param ASC 能力系统组件（处理技能/属性计算）
  * @param AS 属性集（存储玩家具体属性值：血量、蓝量等）
  */
-void AAuraHUD::InitOverlay(APlayerController* PC, APlayerState* PS, UAbilitySystemComponent* ASC, UAttributeSet* AS)
+void AAuraHUD::InitOverlay(const UObject* Requester, APlayerController* PC, APlayerState* PS, UAbilitySystemComponent* ASC, UAttributeSet* AS)
 {
 	// 强制检查：OverlayWidgetClass（UI蓝图模板）未配置时，触发断言并提示（防止运行时崩溃）
 	// 需在BP_AuraHUD的细节面板中选择对应的Overlay UI蓝图
-	checkf(OverlayWidgetClass,TEXT("Overlay Widget Class uninitialized,please fill out BP_AuraHUD"));
+	checkf(!OverlayWidgetClass.IsNull(),TEXT("Overlay Widget Class uninitialized,please fill out BP_AuraHUD"));
 	
 	// 强制检查：OverlayWidgetController（UI逻辑控制器模板）未配置时，触发断言并提示
 	// 需在BP_AuraHUD的细节面板中选择对应的WidgetController蓝图
-	checkf(OverlayWidgetControllerClass,TEXT("Overlay WidgetController Class uninitialized,Please fill out BP_AuraHUD"));
+	checkf(!OverlayWidgetControllerClass.IsNull(),TEXT("Overlay WidgetController Class uninitialized,Please fill out BP_AuraHUD"));
 	
-
-
-	// 根据UI蓝图模板创建Overlay UI实例（先创建父类UUserWidget，后续强转为自定义子类）
-	UUserWidget*Widget = CreateWidget<UUserWidget>(GetWorld(),OverlayWidgetClass);
-	
-	// 将通用UUserWidget强转为自定义UAuraUserWidget，方便调用自定义方法（如SetWidgetController）
-	OverlayWidget = Cast<UAuraUserWidget>(Widget);
+	OverlayUsers.Add(Requester);
 
 	// 构建WidgetController所需的参数结构体：整合玩家核心数据，统一传递给控制器
 	const FWidgetControllerParams WidgetControllerParams(PC,PS,ASC,AS);
+
+	// 重复初始化：UI已经显示并且绑定的就是这一套参数，什么都不用做
+	if (OverlayWidget && OverlayWidget->IsInViewport() && OverlayWidgetController
+		&& OverlayWidgetController->MatchesWidgetControllerParams(WidgetControllerParams))
+	{
+		return;
+	}
+
+	// UI控件只创建一次，之后的初始化（包括重生、切换地图后新的HUD）复用同一个控件，避免叠加多个Overlay
+	UAuraOverlaySubsystem* OverlaySubsystem = ULocalPlayer::GetSubsystem<UAuraOverlaySubsystem>(PC->GetLocalPlayer());
+	if (OverlayWidget == nullptr)
+	{
+		// 根据UI蓝图模板取得/创建Overlay UI实例（自定义UAuraUserWidget，方便调用SetWidgetController）
+		// 蓝图类通常已经在PostInitializeComponents中异步加载完成，没有完成时同步加载并输出警告
+		const TSubclassOf<UAuraUserWidget> WidgetClass = UAuraAssetPreloadSubsystem::ResolveClass(OverlayWidgetClass);
+		OverlayWidget = OverlaySubsystem
+			? OverlaySubsystem->FindOrCreateOverlayWidget(PC, WidgetClass)
+			: CreateWidget<UAuraUserWidget>(PC, WidgetClass);
+	}
 	
-	// 获取/创建Overlay对应的UI逻辑控制器（保证控制器唯一且参数初始化完成）
+	// 获取/创建Overlay对应的UI逻辑控制器，参数变化（新的PlayerState/ASC）时会重新绑定，先解绑旧ASC上的回调
 	UOverlayWidgetController* WidgetController = GetOverlayWidgetController(WidgetControllerParams);
 	
 	// 将UI逻辑控制器绑定到UI控件：实现“UI显示”和“逻辑处理”分离（MVVM设计思路）
 	// 后续UI的数值更新、事件响应，都由WidgetController驱动，UI仅负责显示
 	//这个函数调用的时候会调用一个WidgetControllerSet的函数，在那个函数中使用蓝图实现将一个大OverlayWidget中的两个小的Widget的WidgetController设置为了大OverlayWidget的WidgetController
 	//因为这个函数就是设置大OverlayWidget的WidgetController，能够保证两个小Widget的Controller一定被成功创建
-	OverlayWidget->SetWidgetController(WidgetController);
-	
-	// 二次确认参数设置（兜底：防止控制器参数未正确初始化）
-	WidgetController->SetWidgetControllerParams(WidgetControllerParams);
+	//控制器对象不变时不需要重复设置，避免蓝图中重复绑定委托
+	if (OverlayWidget->WidgetController != WidgetController)
+	{
+		OverlayWidget->SetWidgetController(WidgetController);
+	}
 
 	//当运行到这里的时候AttributeSet已经初始化完成了，同时OverlayWidget已经设定了自己的WidgetController，下面就是OverlayWidget的WidgetController进行广播初始化值了
 	WidgetController->BroadcastInitialValues();
 	
-	
-	// 将Overlay UI添加到游戏视口，玩家屏幕上可见该UI
-	Widget->AddToViewport();
+	// 将Overlay UI添加到游戏视口（或恢复被隐藏的Overlay），玩家屏幕上可见该UI
+	if (OverlaySubsystem)
+	{
+		OverlaySubsystem->ShowOverlay(PC);
+	}
+	else if (!OverlayWidget->IsInViewport())
+	{
+		OverlayWidget->AddToViewport();
+	}
 }
 
+/**
+ * 释放一次Overlay引用
+ * 没有任何使用者时解绑控制器上的属性回调并清空参数（下次InitOverlay会重新绑定），再隐藏UI
+ * 这样不再使用的UI不会继续收到属性广播；控件保留在视口中，重生时只需要恢复可见性
+ */
+void AAuraHUD::ReleaseOverlay(const UObject* Requester)
+{
+	OverlayUsers.Remove(Requester);
+	for (auto It = OverlayUsers.CreateIterator(); It; ++It)
+	{
+		if (!It->IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+	if (OverlayUsers.Num() > 0)
+	{
+		return;
+	}
 
+	if (OverlayWidgetController)
+	{
+		OverlayWidgetController->UnbindCallbacksFromDependencies();
+		OverlayWidgetController->SetWidgetControllerParams(FWidgetControllerParams());
+	}
+	if (UAuraOverlaySubsystem* OverlaySubsystem = ULocalPlayer::GetSubsystem<UAuraOverlaySubsystem>(GetOwningPlayerController()->GetLocalPlayer()))
+	{
+		OverlaySubsystem->HideOverlay();
+	}
+	else if (OverlayWidget)
+	{
+		OverlayWidget->RemoveFromParent();
+	}
+}
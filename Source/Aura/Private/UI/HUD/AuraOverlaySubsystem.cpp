@@ -0,0 +1,97 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "UI/HUD/AuraOverlaySubsystem.h"
+
+#include "Aura/Aura.h"
+#include "Engine/LocalPlayer.h"
+#include "UI/Widget/AuraUserWidget.h"
+#include "UI/WidgetController/OverlayWidgetController.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Overlay Widgets Created"), STAT_AuraOverlayWidgetsCreated, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Overlay Widgets Reused"), STAT_AuraOverlayWidgetsReused, STATGROUP_Aura);
+
+void UAuraOverlaySubsystem::Deinitialize()
+{
+	if (OverlayWidgetController)
+	{
+		OverlayWidgetController->UnbindCallbacksFromDependencies();
+	}
+	if (OverlayWidget)
+	{
+		OverlayWidget->RemoveFromParent();
+	}
+	OverlayWidget = nullptr;
+	OverlayWidgetController = nullptr;
+
+	Super::Deinitialize();
+}
+
+UAuraUserWidget* UAuraOverlaySubsystem::FindOrCreateOverlayWidget(APlayerController* OwningPlayer, TSubclassOf<UAuraUserWidget> WidgetClass)
+{
+	if (OverlayWidget && OverlayWidget->GetClass() == WidgetClass)
+	{
+		INC_DWORD_STAT(STAT_AuraOverlayWidgetsReused);
+		return OverlayWidget;
+	}
+
+	if (OverlayWidget)
+	{
+		OverlayWidget->RemoveFromParent();
+	}
+
+	// 以玩家控制器作为拥有者创建，控件的Outer是GameInstance，切换世界后仍然有效
+	OverlayWidget = CreateWidget<UAuraUserWidget>(OwningPlayer, WidgetClass);
+	VisibilityBeforeHide.Reset();
+	INC_DWORD_STAT(STAT_AuraOverlayWidgetsCreated);
+	return OverlayWidget;
+}
+
+UOverlayWidgetController* UAuraOverlaySubsystem::FindOrCreateOverlayWidgetController(TSubclassOf<UOverlayWidgetController> ControllerClass)
+{
+	if (OverlayWidgetController && OverlayWidgetController->GetClass() == ControllerClass)
+	{
+		return OverlayWidgetController;
+	}
+
+	if (OverlayWidgetController)
+	{
+		OverlayWidgetController->UnbindCallbacksFromDependencies();
+	}
+
+	// 控制器的Outer是本子系统，不随HUD销毁
+	OverlayWidgetController = NewObject<UOverlayWidgetController>(this, ControllerClass);
+	return OverlayWidgetController;
+}
+
+void UAuraOverlaySubsystem::ShowOverlay(APlayerController* OwningPlayer)
+{
+	if (OverlayWidget == nullptr)
+	{
+		return;
+	}
+
+	if (VisibilityBeforeHide.IsSet())
+	{
+		OverlayWidget->SetVisibility(VisibilityBeforeHide.GetValue());
+		VisibilityBeforeHide.Reset();
+	}
+
+	// 切换地图时引擎会把控件从视口移除，这里用新的玩家控制器更新上下文后重新加入
+	if (!OverlayWidget->IsInViewport())
+	{
+		OverlayWidget->SetPlayerContext(FLocalPlayerContext(OwningPlayer));
+		OverlayWidget->AddToViewport();
+	}
+}
+
+void UAuraOverlaySubsystem::HideOverlay()
+{
+	if (OverlayWidget == nullptr || VisibilityBeforeHide.IsSet())
+	{
+		return;
+	}
+
+	VisibilityBeforeHide = OverlayWidget->GetVisibility();
+	OverlayWidget->SetVisibility(ESlateVisibility::Collapsed);
+}
@@ -11,6 +11,14 @@ void UAuraWidgetController::SetWidgetControllerParams(const FWidgetControllerPar
 	AttributeSet = params.AttributSet;
 }
 
+bool UAuraWidgetController::MatchesWidgetControllerParams(const FWidgetControllerParams& params) const
+{
+	return PlayerController == params.PlayerController
+		&& PlayerState == params.PlayerState
+		&& AbilitySystemComponent == params.AbilitySystemComponent
+		&& AttributeSet == params.AttributSet;
+}
+
 void UAuraWidgetController::BroadcastInitialValues()
 {
 	
@@ -5,88 +5,187 @@
 
 #include "AttributeSet.h"
 #include "AbilitySystem/AuraAttributeSet.h"
+#include "Aura/Aura.h"
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("UI Attribute Broadcasts"), STAT_AuraUIAttributeBroadcasts, STATGROUP_Aura);
+DECLARE_DWORD_COUNTER_STAT(TEXT("UI Attribute Broadcasts Suppressed"), STAT_AuraUIAttributeBroadcastsSuppressed, STATGROUP_Aura);
+
+
+namespace AuraOverlayBindings
+{
+	//旧版单独委托对应的属性，新增的属性只走通用委托
+	static EAuraVitalIndex GetLegacyIndex(const FGameplayAttribute& Attribute)
+	{
+		if (Attribute == UAuraAttributeSet::GetHealthAttribute()) return EAuraVitalIndex::Health;
+		if (Attribute == UAuraAttributeSet::GetMaxHealthAttribute()) return EAuraVitalIndex::MaxHealth;
+		if (Attribute == UAuraAttributeSet::GetManaAttribute()) return EAuraVitalIndex::Mana;
+		if (Attribute == UAuraAttributeSet::GetMaxManaAttribute()) return EAuraVitalIndex::MaxMana;
+		return EAuraVitalIndex::Num;
+	}
+}
 
 /**
  * 广播属性初始值（核心作用：UI首次加载时，显示初始的血量/最大血量，避免UI空白）
  * 执行时机：WidgetController初始化完成后立即调用，给UI“填初始值”
+ * 初始值不经过合并，直接对绑定表中的每个属性广播一次
  */
 void UOverlayWidgetController::BroadcastInitialValues()
 {
-	// 强制转换AttributeSet为自定义的AuraAttributeSet（GAS属性集）
-	// CastChecked：转换失败时触发断言（方便调试），确保AttributeSet是预期的类型（非空且是AuraAttributeSet）
-	UAuraAttributeSet* AuraAttributeSet = CastChecked<UAuraAttributeSet>(AttributeSet);
-	
-	// 广播初始血量值 → 触发UI更新（比如血条显示初始血量）
-	OnHealthChanged.Broadcast(AuraAttributeSet->GetHealth());
-	// 广播初始最大血量值 → 触发UI更新（比如血条的最大长度匹配初始最大血量）
-	OnMaxHealthChanged.Broadcast(AuraAttributeSet->GetMaxHealth());
+	check(AbilitySystemComponent);
 	
-	//和上面类似
-	OnManaChanged.Broadcast(AuraAttributeSet->GetMana());
-	
-	OnMaxManaChanged.Broadcast(AuraAttributeSet->GetMaxMana());
+	for (int32 i = 0; i < AttributeBindings.Num(); ++i)
+	{
+		BroadcastAttribute(i, AbilitySystemComponent->GetNumericAttribute(AttributeBindings[i].Attribute));
+	}
 }
 
 /**
  * 绑定属性变化的回调到GAS（游戏能力系统）依赖项
- * 核心作用：监听GAS中血量/最大血量的属性变化，注册“属性变了要执行的回调函数”
- * 执行时机：WidgetController初始化时（早于BroadcastInitialValues），仅需注册一次
+ * 核心作用：遍历属性集类中的所有FGameplayAttribute生成绑定表，每个属性注册同一个回调，用下标区分属性
+ * 新增属性时这里不需要任何改动；委托句柄保存在绑定表中，重复调用时会先解绑旧的回调
  */
 void UOverlayWidgetController::BindCallbacksToDependencies()
 {
-	// 转换为自定义属性集（const修饰：仅读取属性，不修改）
-	const UAuraAttributeSet* AuraAttributeSet = CastChecked<UAuraAttributeSet>(AttributeSet);
+	check(AbilitySystemComponent);
+	check(AttributeSet);
+	
+	UnbindCallbacksFromDependencies();
 	
-	// 1. 绑定“当前血量”属性变化的回调：
-	// GetGameplayAttributeValueChangeDelegate：GAS提供的接口，获取指定属性（血量）的变化委托
-	// AddUObject：将“血量变化时要执行的函数（HealthChanged）”绑定到该委托，关联当前WidgetController实例
-	AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(AuraAttributeSet->GetHealthAttribute()
-		).AddUObject(this,&UOverlayWidgetController::HealthChanged);
+	TArray<FGameplayAttribute> Attributes;
+	UAttributeSet::GetAttributesFromSetClass(AttributeSet->GetClass(), Attributes);
 	
-	// 2. 绑定“最大血量”属性变化的回调：逻辑同上，监听最大血量属性变化
-	AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(AuraAttributeSet->GetMaxHealthAttribute()
-		).AddUObject(this,&UOverlayWidgetController::MaxHealthChanged);
+	AttributeBindings.Reset(Attributes.Num());
+	for (const FGameplayAttribute& Attribute : Attributes)
+	{
+		const int32 BindingIndex = AttributeBindings.AddDefaulted();
+		FAttributeBinding& Binding = AttributeBindings[BindingIndex];
+		Binding.Attribute = Attribute;
+		Binding.LegacyIndex = AuraOverlayBindings::GetLegacyIndex(Attribute);
+		
+		// GetGameplayAttributeValueChangeDelegate：GAS提供的接口，获取指定属性的变化委托
+		// AddUObject的最后一个参数是负载参数，回调时原样传回，用来找到绑定表中的记录
+		Binding.Handle = AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(Attribute
+			).AddUObject(this, &UOverlayWidgetController::AttributeChanged, BindingIndex);
+	}
 	
-	//和上面一样只不过时魔力的
-	AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(AuraAttributeSet->GetManaAttribute()
-		).AddUObject(this,&UOverlayWidgetController::ManaChanged);
+	PendingBroadcastBits.Init(false, AttributeBindings.Num());
+	BoundAbilitySystemComponent = AbilitySystemComponent;
+}
+
+void UOverlayWidgetController::UnbindCallbacksFromDependencies()
+{
+	if (UAbilitySystemComponent* BoundASC = BoundAbilitySystemComponent.Get())
+	{
+		for (const FAttributeBinding& Binding : AttributeBindings)
+		{
+			BoundASC->GetGameplayAttributeValueChangeDelegate(Binding.Attribute).Remove(Binding.Handle);
+		}
+	}
 	
-	//和上面一致
-	AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(AuraAttributeSet->GetManaAttribute()
-		).AddUObject(this,&UOverlayWidgetController::ManaChanged);
+	AttributeBindings.Reset();
+	PendingBroadcastBits.Reset();
+	BoundAbilitySystemComponent.Reset();
 }
 
 /**
- * 血量属性变化的回调函数（由GAS自动触发）
+ * 属性变化的回调函数（由GAS自动触发，所有属性共用）
  * @param Data GAS传递的属性变化数据（包含旧值、新值、变化原因等）
- * 执行时机：GAS中“当前血量”属性被修改时（比如受击掉血、回血、死亡）
+ * @param BindingIndex 该属性在绑定表中的下标
  */
-void UOverlayWidgetController::HealthChanged(const FOnAttributeChangeData& Data) const
+void UOverlayWidgetController::AttributeChanged(const FOnAttributeChangeData& Data, int32 BindingIndex)
 {
-	// 广播最新血量值 → 通知UI更新（比如血条进度、血量数字显示）
-	OnHealthChanged.Broadcast(Data.NewValue);
+	QueueBroadcast(BindingIndex, Data.NewValue);
+}
+
+void UOverlayWidgetController::BeginDestroy()
+{
+	// 控制器销毁前移除还没执行的Ticker，避免回调到已销毁的对象
+	if (FlushTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(FlushTickerHandle);
+		FlushTickerHandle.Reset();
+	}
+	UnbindCallbacksFromDependencies();
+	Super::BeginDestroy();
 }
 
 /**
- * 最大血量属性变化的回调函数（由GAS自动触发）
- * @param Data GAS传递的属性变化数据
- * 执行时机：GAS中“最大血量”属性被修改时（比如升级、加buff、装备加成）
+ * 记录一次属性变化
+ * 合并模式下同一个属性在一次刷新前多次变化只保留最新值，被覆盖掉的广播计入STAT_AuraUIAttributeBroadcastsSuppressed
  */
-void UOverlayWidgetController::MaxHealthChanged(const FOnAttributeChangeData& Data) const
+void UOverlayWidgetController::QueueBroadcast(int32 BindingIndex, float NewValue)
 {
-	// 广播最新最大血量值 → 通知UI更新（比如血条总长度、最大血量数字显示）
-	OnMaxHealthChanged.Broadcast(Data.NewValue);
+	if (!AttributeBindings.IsValidIndex(BindingIndex))
+	{
+		return;
+	}
+	
+	if (!bCoalesceAttributeBroadcasts)
+	{
+		BroadcastAttribute(BindingIndex, NewValue);
+		return;
+	}
+
+	if (PendingBroadcastBits[BindingIndex])
+	{
+		INC_DWORD_STAT(STAT_AuraUIAttributeBroadcastsSuppressed);
+	}
+	PendingBroadcastBits[BindingIndex] = true;
+	AttributeBindings[BindingIndex].PendingValue = NewValue;
+
+	// 只在第一次变脏时注册一次性Ticker，刷新后再有变化会重新注册
+	if (!FlushTickerHandle.IsValid())
+	{
+		FlushTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+			FTickerDelegate::CreateUObject(this, &UOverlayWidgetController::FlushPendingBroadcasts), BroadcastInterval);
+	}
 }
 
-//和上面一致，只不过是魔力
-void UOverlayWidgetController::ManaChanged(const FOnAttributeChangeData& Data) const
+void UOverlayWidgetController::BroadcastAttribute(int32 BindingIndex, float NewValue) const
 {
-	OnManaChanged.Broadcast(Data.NewValue);
+	INC_DWORD_STAT(STAT_AuraUIAttributeBroadcasts);
+
+	const FAttributeBinding& Binding = AttributeBindings[BindingIndex];
+	if (!bBroadcastLegacyVitalDelegates || Binding.LegacyIndex == EAuraVitalIndex::Num)
+	{
+		OnAttributeChanged.Broadcast(Binding.Attribute, NewValue);
+		return;
+	}
+
+	// 兼容已有的UI蓝图：生命/魔力只通过原来的单独委托广播，不再经过通用委托，每次变化只触发一次蓝图
+	switch (Binding.LegacyIndex)
+	{
+	case EAuraVitalIndex::Health:
+		OnHealthChanged.Broadcast(NewValue);
+		break;
+	case EAuraVitalIndex::MaxHealth:
+		OnMaxHealthChanged.Broadcast(NewValue);
+		break;
+	case EAuraVitalIndex::Mana:
+		OnManaChanged.Broadcast(NewValue);
+		break;
+	case EAuraVitalIndex::MaxMana:
+		OnMaxManaChanged.Broadcast(NewValue);
+		break;
+	default:
+		break;
+	}
 }
 
-//和上面一致只不过是魔力
-void UOverlayWidgetController::MaxManaChanged(const FOnAttributeChangeData& Data) const
+bool UOverlayWidgetController::FlushPendingBroadcasts(float DeltaTime)
 {
-	OnMaxManaChanged.Broadcast(Data.NewValue);
+	FlushTickerHandle.Reset();
+
+	// 先清空掩码再广播，蓝图回调中引起的新变化会进入下一次刷新
+	const TBitArray<> Pending = PendingBroadcastBits;
+	PendingBroadcastBits.Init(false, AttributeBindings.Num());
+	for (TConstSetBitIterator<> It(Pending); It; ++It)
+	{
+		const int32 BindingIndex = It.GetIndex();
+		if (AttributeBindings.IsValidIndex(BindingIndex))
+		{
+			BroadcastAttribute(BindingIndex, AttributeBindings[BindingIndex].PendingValue);
+		}
+	}
+	return false;
 }
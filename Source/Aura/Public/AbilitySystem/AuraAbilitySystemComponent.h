@@ -6,6 +6,47 @@
 #include "AbilitySystemComponent.h"
 #include "AuraAbilitySystemComponent.generated.h"
 
+class UNetConnection;
+
+/**
+ * @brief 按连接（每个玩家）区分的属性集复制策略
+ * @details 敌人数量多的时候，每个客户端都会收到所有敌人的血量变化，这里按距离和交互状态降低发送频率：
+ * 1. 玩家鼠标悬停的敌人，或距离在FullRateDistance以内的敌人：每次网络更新都发送
+ * 2. 距离在ReducedRateDistance以内：每ReducedRateInterval秒最多发送一次
+ * 3. 更远的敌人：每FarRateInterval秒最多发送一次，为0时只在血量跨过阈值时发送
+ * 4. 不论距离，血量比例跨过一个HealthThresholdStep档位时立即发送
+ * 5. 首次复制和进入网络休眠前的最后一次复制总是发送
+ */
+USTRUCT(BlueprintType)
+struct FAuraAttributeReplicationPolicy
+{
+	GENERATED_BODY()
+
+	//是否启用按连接的复制策略，关闭时和默认GAS行为一致
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replication")
+	bool bEnabled = false;
+
+	//全频率发送的距离（厘米）
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replication", meta = (EditCondition = "bEnabled"))
+	float FullRateDistance = 1500.0f;
+
+	//降频发送的距离（厘米），超过这个距离视为远处敌人
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replication", meta = (EditCondition = "bEnabled"))
+	float ReducedRateDistance = 4000.0f;
+
+	//降频发送的最小间隔（秒）
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replication", meta = (EditCondition = "bEnabled"))
+	float ReducedRateInterval = 0.25f;
+
+	//远处敌人的最小发送间隔（秒），为0时远处敌人只在跨过血量阈值时发送（阈值以内的小变化会一直得不到发送）
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replication", meta = (EditCondition = "bEnabled"))
+	float FarRateInterval = 1.0f;
+
+	//血量比例阈值档位，例如0.1表示每掉/回10%最大血量必定发送一次
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replication", meta = (EditCondition = "bEnabled", ClampMin = "0.01", ClampMax = "1.0"))
+	float HealthThresholdStep = 0.1f;
+};
+
 /**
  * 
  */
@@ -13,5 +54,30 @@ UCLASS()
 class AURA_API UAuraAbilitySystemComponent : public UAbilitySystemComponent
 {
 	GENERATED_BODY()
-	
+public:
+	//属性集按连接的复制策略（敌人在构造函数中开启）
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replication")
+	FAuraAttributeReplicationPolicy AttributeReplicationPolicy;
+
+	/**
+	 * 重写子对象复制：每个连接都会调用一次，在这里决定本次是否向该连接复制属性集
+	 * 跳过的属性变更不会丢失，下次复制到该连接时会把最新值一起发送
+	 */
+	virtual bool ReplicateSubobjects(class UActorChannel* Channel, class FOutBunch* Bunch, FReplicationFlags* RepFlags) override;
+
+private:
+	//每个连接上一次发送属性集的状态
+	struct FConnectionAttributeRepState
+	{
+		double LastSendTime = 0.0;
+		int32 LastHealthBucket = INDEX_NONE;
+	};
+
+	TMap<TWeakObjectPtr<UNetConnection>, FConnectionAttributeRepState> ConnectionAttributeRepStates;
+
+	//根据复制策略判断本次是否向该连接复制属性集
+	bool ShouldReplicateAttributesTo(UNetConnection* Connection, const FReplicationFlags& RepFlags);
+
+	//当前血量所在的阈值档位
+	int32 GetHealthBucket() const;
 };
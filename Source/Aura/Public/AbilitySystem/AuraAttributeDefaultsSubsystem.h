@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AttributeSet.h"
+#include "Engine/DataTable.h"
+#include "ScalableFloat.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "AuraAttributeDefaultsSubsystem.generated.h"
+
+class UAbilitySystemComponent;
+
+//默认值表中的一个属性：数值可以是常量，也可以引用曲线表中随等级变化的曲线
+USTRUCT(BlueprintType)
+struct FAuraAttributeDefaultValue
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Attributes")
+	FGameplayAttribute Attribute;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Attributes")
+	FScalableFloat Value;
+};
+
+/**
+ * 属性默认值表（DataTable）的一行，行名就是角色类型（例如Player、Goblin）
+ * 角色通过AttributeDefaultsName引用一行，再按CharacterLevel取值
+ */
+USTRUCT(BlueprintType)
+struct FAuraAttributeDefaultsRow : public FTableRowBase
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Attributes")
+	TArray<FAuraAttributeDefaultValue> Attributes;
+};
+
+//某个角色类型在某个等级下求值后的默认属性，两个数组一一对应
+struct FAuraBakedAttributeDefaults
+{
+	TArray<FGameplayAttribute> Attributes;
+	TArray<float> Values;
+
+	//取得某个属性的默认值，表中没有这个属性时返回DefaultValue
+	float GetValue(const FGameplayAttribute& Attribute, float DefaultValue) const;
+};
+
+/**
+ * @brief 表驱动的初始属性
+ * @details 1. 默认值表在DefaultGame.ini的[/Script/Aura.AuraAttributeDefaultsSubsystem]中配置
+ * 2. 每个（角色类型，等级）只求值一次曲线，结果缓存，同一波刷出的同类敌人直接复用
+ * 3. 初始化时一次性写入属性集的所有属性，不需要为每个属性（或每个敌人）应用一次初始化GameplayEffect
+ */
+UCLASS(Config = Game)
+class AURA_API UAuraAttributeDefaultsSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	//取得（必要时求值并缓存）某个角色类型在某个等级下的默认属性，表中没有这一行时返回nullptr
+	const FAuraBakedAttributeDefaults* FindDefaults(FName DefaultsName, int32 Level);
+
+	//把默认属性写入能力系统组件上的所有Aura属性集，表中没有这一行时返回false（保留属性集构造时的默认值）
+	bool ApplyDefaults(UAbilitySystemComponent* AbilitySystemComponent, FName DefaultsName, int32 Level);
+
+	//便捷函数：通过WorldContext找到子系统
+	static UAuraAttributeDefaultsSubsystem* Get(const UObject* WorldContext);
+
+	//属性默认值表，行结构为FAuraAttributeDefaultsRow
+	UPROPERTY(Config)
+	TSoftObjectPtr<UDataTable> AttributeDefaultsTable;
+
+private:
+	UPROPERTY(Transient)
+	TObjectPtr<UDataTable> LoadedTable;
+
+	TMap<TPair<FName, int32>, FAuraBakedAttributeDefaults> BakedDefaults;
+};
@@ -7,6 +7,9 @@
 #include "AttributeSet.h"
 #include "AuraAttributeSet.generated.h"
 
+class UAuraEnemyAttributeStore;
+struct FNetDeltaSerializeInfo;
+
 
 #define ATTRIBUTE_ACCESSORS(ClassName, PropertyName) \
 	GAMEPLAYATTRIBUTE_PROPERTY_GETTER(ClassName, PropertyName) \
@@ -14,10 +17,64 @@
 	GAMEPLAYATTRIBUTE_VALUE_SETTER(PropertyName) \
 	GAMEPLAYATTRIBUTE_VALUE_INITTER(PropertyName)
 //使用上面的这些宏能为下面的属性挺空get和set和init方法，因为这些方法提供的方法和属性是一种类型
+
+//打包复制模式下生命/魔力四个属性在掩码和数组中的下标
+enum class EAuraVitalIndex : uint8
+{
+	Health,
+	MaxHealth,
+	Mana,
+	MaxMana,
+	Num
+};
+
+/**
+ * @brief 生命/魔力属性的打包复制结构体（打包复制模式下代替四个FGameplayAttributeData单独复制）
+ * @details 1. 数值按0.1的精度量化为整数，低于精度的抖动不会触发复制
+ * 2. 按连接增量发送：每个连接记录上一次发给它的量化值，只发送和它不同的属性，未变化的属性只占掩码中的1位
+ *    丢包时引擎会把该连接的基准退回到最后一次确认的状态，丢失的修改会在下一次复制中补发
+ * 3. 当前值与基础值相同时只发送一次（绝大多数情况）
+ */
+USTRUCT()
+struct FAuraPackedVitals
+{
+	GENERATED_BODY()
+
+	//客户端：最近一次收到的更新中包含的属性掩码，每一位对应一个EAuraVitalIndex（服务器上不使用）
+	uint8 ReceivedMask = 0;
+
+	//量化后的当前值（UHT不支持枚举作为数组长度，长度和EAuraVitalIndex::Num一致）
+	UPROPERTY()
+	int32 QuantizedCurrent[4] = {};
+
+	//量化后的基础值
+	UPROPERTY()
+	int32 QuantizedBase[4] = {};
+
+	//写入一个属性的当前值和基础值，量化后的数值没有变化时返回false
+	bool SetValue(EAuraVitalIndex Index, float CurrentValue, float BaseValue);
+
+	float GetCurrentValue(EAuraVitalIndex Index) const;
+	float GetBaseValue(EAuraVitalIndex Index) const;
+	bool WasReceived(EAuraVitalIndex Index) const { return (ReceivedMask & (1 << (uint8)Index)) != 0; }
+
+	//按连接的增量序列化：掩码 + 和该连接上一次发送的值不同的属性（变长整数编码）
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms);
+};
+
+template<>
+struct TStructOpsTypeTraits<FAuraPackedVitals> : public TStructOpsTypeTraitsBase2<FAuraPackedVitals>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
 /**
  * 
  */
-UCLASS()
+UCLASS(Config = Game)
 class AURA_API UAuraAttributeSet : public UAttributeSet
 {
 	GENERATED_BODY()
@@ -27,6 +84,32 @@ public:
 	// 重写生命周期复制属性函数，用于注册需要网络同步的属性（GAS属性同步核心）
 	virtual void GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const override;
 
+	//服务器上属性当前值变化后调用，标记推送模型的脏属性，打包复制模式下在这里刷新PackedVitals
+	virtual void PostAttributeChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue) override;
+
+	//服务器上属性基础值变化后调用，标记推送模型的脏属性
+	virtual void PostAttributeBaseChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue) const override;
+
+	/**
+	 * 一次性写入一组属性的初始值（基础值和当前值），由UAuraAttributeDefaultsSubsystem调用
+	 * 不属于本属性集的属性会被跳过；已经有激活的效果时改为通过ASC设置基础值，让修改器重新聚合
+	 */
+	void InitAttributesFromDefaults(TConstArrayView<FGameplayAttribute> Attributes, TConstArrayView<float> Values);
+
+	//敌人：注册到属性仓库，之后当前值的变化（服务器修改、客户端复制）都会写入仓库；重复调用无效
+	void BindAttributeStore(UAuraEnemyAttributeStore* Store);
+	void UnbindAttributeStore();
+
+	virtual void BeginDestroy() override;
+
+	/**
+	 * 是否使用打包复制模式（在DefaultGame.ini的[/Script/Aura.AuraAttributeSet]中配置，默认关闭）
+	 * 开启后Health/MaxHealth/Mana/MaxMana不再单独复制，而是通过PackedVitals一次性发送量化后的数值
+	 * @note GetLifetimeReplicatedProps在CDO上调用，所以这是一个类级别的开关，运行时修改无效
+	 */
+	UPROPERTY(Config)
+	bool bUsePackedVitalReplication = false;
+
 	// 生命值属性（GAS标准属性类型）：蓝图只读，同步触发OnRep_Health回调
 	UPROPERTY(BlueprintReadOnly, ReplicatedUsing = OnRep_Health, Category = "Vital Attributes")
 	FGameplayAttributeData Health;
@@ -46,6 +129,39 @@ public:
 	FGameplayAttributeData MaxMana;
 	ATTRIBUTE_ACCESSORS(UAuraAttributeSet, MaxMana);
 
+	/*
+	 * 主属性：由默认值表、升级或装备设置，次级属性由它们推导（见UAuraDerivedAttributeSubsystem）
+	 */
+	
+	//力量
+	UPROPERTY(BlueprintReadOnly, ReplicatedUsing = OnRep_Strength, Category = "Primary Attributes")
+	FGameplayAttributeData Strength;
+	ATTRIBUTE_ACCESSORS(UAuraAttributeSet, Strength);
+
+	//智力
+	UPROPERTY(BlueprintReadOnly, ReplicatedUsing = OnRep_Intelligence, Category = "Primary Attributes")
+	FGameplayAttributeData Intelligence;
+	ATTRIBUTE_ACCESSORS(UAuraAttributeSet, Intelligence);
+
+	//韧性
+	UPROPERTY(BlueprintReadOnly, ReplicatedUsing = OnRep_Resilience, Category = "Primary Attributes")
+	FGameplayAttributeData Resilience;
+	ATTRIBUTE_ACCESSORS(UAuraAttributeSet, Resilience);
+
+	//活力
+	UPROPERTY(BlueprintReadOnly, ReplicatedUsing = OnRep_Vigor, Category = "Primary Attributes")
+	FGameplayAttributeData Vigor;
+	ATTRIBUTE_ACCESSORS(UAuraAttributeSet, Vigor);
+
+	/*
+	 * 次级属性：基础值由推导规则计算，GameplayEffect的修改器叠加在基础值之上
+	 */
+	
+	//护甲
+	UPROPERTY(BlueprintReadOnly, ReplicatedUsing = OnRep_Armor, Category = "Secondary Attributes")
+	FGameplayAttributeData Armor;
+	ATTRIBUTE_ACCESSORS(UAuraAttributeSet, Armor);
+
 	// 生命值同步回调：接收同步前的旧值，用于客户端视觉/逻辑反馈（如受伤特效）
 	UFUNCTION()
 	void OnRep_Health(const FGameplayAttributeData& OldHealth) const;
@@ -60,4 +176,48 @@ public:
 	
 	UFUNCTION()
 	void OnRep_MaxMana(const FGameplayAttributeData& OldMaxMana) const;
+
+	UFUNCTION()
+	void OnRep_Strength(const FGameplayAttributeData& OldStrength) const;
+
+	UFUNCTION()
+	void OnRep_Intelligence(const FGameplayAttributeData& OldIntelligence) const;
+
+	UFUNCTION()
+	void OnRep_Resilience(const FGameplayAttributeData& OldResilience) const;
+
+	UFUNCTION()
+	void OnRep_Vigor(const FGameplayAttributeData& OldVigor) const;
+
+	UFUNCTION()
+	void OnRep_Armor(const FGameplayAttributeData& OldArmor) const;
+
+private:
+	//打包复制模式下的复制数据，服务器写入，客户端在OnRep_PackedVitals中解包回四个属性
+	UPROPERTY(ReplicatedUsing = OnRep_PackedVitals)
+	FAuraPackedVitals PackedVitals;
+
+	//解包并对每个被修改过的属性走一遍GAMEPLAYATTRIBUTE_REPNOTIFY，保持和单独复制时一致的客户端行为
+	UFUNCTION()
+	void OnRep_PackedVitals();
+
+	//把属性对应的复制属性标记为脏（推送模型），并通知拥有者有复制活动
+	void MarkAttributeDirty(const FGameplayAttribute& Attribute) const;
+
+	//只标记复制属性为脏，批量写入时最后统一调用一次NotifyReplicationActivity
+	void MarkAttributePropertyDirty(const FGameplayAttribute& Attribute) const;
+
+	//通知拥有者（PlayerState或敌人）有复制活动
+	void NotifyReplicationActivity() const;
+
+	//按下标取得对应的属性数据，打包和解包时使用
+	FGameplayAttributeData& GetVitalData(EAuraVitalIndex Index);
+
+	//把属性的当前值写入属性仓库（没有注册时什么都不做）
+	void SyncAttributeStore(const FGameplayAttribute& Attribute) const;
+
+	TWeakObjectPtr<UAuraEnemyAttributeStore> AttributeStore;
+
+	//在属性仓库中的编号
+	int32 AttributeStoreId = INDEX_NONE;
 };
@@ -0,0 +1,195 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AttributeSet.h"
+#include "Engine/DataTable.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tasks/Task.h"
+#include "UObject/ObjectKey.h"
+#include "AuraDerivedAttributeSubsystem.generated.h"
+
+class UAbilitySystemComponent;
+struct FOnAttributeChangeData;
+
+//推导规则中的一项：来源属性（当前值，包含Buff）乘以系数
+USTRUCT(BlueprintType)
+struct FAuraDerivedAttributeTerm
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Attributes")
+	FGameplayAttribute Source;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Attributes")
+	float Coefficient = 1.0f;
+};
+
+/**
+ * 推导规则表（DataTable）的一行：Target的基础值 = BaseValue + Σ(来源属性 × 系数)
+ * 例如 护甲 = 2 + 0.25 × 韧性，最大生命值 = 80 + 2.5 × 活力
+ * 次级属性也可以作为其他规则的来源，子系统按依赖顺序计算
+ */
+USTRUCT(BlueprintType)
+struct FAuraDerivedAttributeRow : public FTableRowBase
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Attributes")
+	FGameplayAttribute Target;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Attributes")
+	float BaseValue = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Attributes")
+	TArray<FAuraDerivedAttributeTerm> Terms;
+};
+
+//加载后的推导规则，Sources和Coefficients一一对应
+struct FAuraCompiledDerivedRule
+{
+	FGameplayAttribute Target;
+	float BaseValue = 0.0f;
+	TArray<FGameplayAttribute> Sources;
+	TArray<float> Coefficients;
+
+	//批量计算用：目标和来源在BatchAttributes中的下标
+	int32 TargetBatchIndex = INDEX_NONE;
+	TArray<int32> SourceBatchIndices;
+
+	//目标属性同时是其他规则的来源时，在SourceAttributes中的下标
+	int32 TargetSourceIndex = INDEX_NONE;
+};
+
+/**
+ * @brief 次级属性推导
+ * @details 1. 规则表在DefaultGame.ini的[/Script/Aura.AuraDerivedAttributeSubsystem]中配置，加载时按依赖关系排序，
+ *    并为每个来源属性预先算出受影响的规则（包括间接依赖）
+ * 2. 服务器上注册的能力系统组件，来源属性变化时只把受影响的规则标记为脏，同一帧内多次变化（多个Buff）只记一次
+ * 3. 每帧统一按依赖顺序重新计算脏规则，把结果写入目标属性的基础值，GameplayEffect的修改器仍然叠加在上面
+ * 代替为每个次级属性挂一个带MMC的无限效果：那种做法每次来源变化都会触发重新聚合，Buff多的角色会连锁重算
+ * 4. 全局变化（难度缩放、全局Buff）需要重算所有敌人时走批量路径：游戏线程抓取输入快照，
+ *    工作线程用ParallelFor分块计算，完成后在游戏线程一次性写回（通过ASC写基础值，属性变化委托和客户端的RepNotify照常触发）
+ */
+UCLASS(Config = Game)
+class AURA_API UAuraDerivedAttributeSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	//服务器：注册能力系统组件（属性集已经添加、初始属性已经写入之后），所有规则标记为脏；重复调用无效
+	//bApplyEnemyScale：是否受SetEnemyAttributeScale（难度缩放）影响
+	void RegisterAbilitySystem(UAbilitySystemComponent* AbilitySystemComponent, bool bApplyEnemyScale = false);
+	void UnregisterAbilitySystem(UAbilitySystemComponent* AbilitySystemComponent);
+
+	//把能力系统组件的所有规则标记为脏，下一帧重新计算
+	void MarkAllDirty(UAbilitySystemComponent* AbilitySystemComponent);
+
+	//立即重新计算能力系统组件上的脏规则
+	void RecomputeNow(UAbilitySystemComponent* AbilitySystemComponent);
+
+	//设置敌人某个次级属性推导结果的缩放（难度），会触发一次批量重算；Target不是任何规则的目标时返回false
+	bool SetEnemyAttributeScale(const FGameplayAttribute& Target, float Scale);
+
+	//请求重算所有注册的能力系统组件（异步计算，完成后的那一帧统一写回）
+	void RequestBatchRecompute();
+
+	bool IsBatchRecomputeInFlight() const { return PendingBatch.IsValid(); }
+
+	//推导规则表，行结构为FAuraDerivedAttributeRow
+	UPROPERTY(Config)
+	TSoftObjectPtr<UDataTable> DerivedAttributeRules;
+
+private:
+	//一个注册的能力系统组件
+	struct FEntry
+	{
+		TWeakObjectPtr<UAbilitySystemComponent> AbilitySystemComponent;
+
+		//和Rules下标一致
+		TBitArray<> DirtyRules;
+
+		//是否已经在DirtyEntries中
+		bool bQueued = false;
+
+		TArray<TPair<FGameplayAttribute, FDelegateHandle>> DelegateHandles;
+
+		bool bApplyEnemyScale = false;
+
+		//每次标记为脏时递增，批量结果写回时版本不一致的组件跳过，所有规则标记为脏交给逐帧路径计算
+		uint32 Revision = 0;
+	};
+
+	//一次批量重算：输入快照、输出，行数等于组件数量
+	struct FBatch
+	{
+		TArray<TObjectKey<UAbilitySystemComponent>> Keys;
+		TArray<uint32> Revisions;
+
+		//每个组件一行，按BatchAttributes排列的当前值
+		TArray<float> Values;
+
+		//每个组件一行，按Rules排列：组件上是否有目标属性、目标属性的旧基础值、新基础值、估计的新当前值
+		TArray<uint8> TargetValid;
+		TArray<float> OldBases;
+		TArray<float> NewBases;
+		TArray<float> EstimatedCurrents;
+
+		//每个组件一行，按Rules排列的缩放
+		TArray<float> Scales;
+	};
+
+	//游戏线程：抓取所有组件的输入并启动异步计算
+	void LaunchBatch();
+
+	//工作线程：计算一段组件
+	void EvaluateBatchRange(FBatch& Batch, int32 Begin, int32 End) const;
+
+	//游戏线程：写回批量结果
+	void CommitBatch(const FBatch& Batch);
+
+	//读取规则表，按依赖排序并计算每个来源属性影响的规则
+	void CompileRules(const UDataTable* RuleTable);
+
+	void OnSourceAttributeChanged(const FOnAttributeChangeData& Data, TObjectKey<UAbilitySystemComponent> Key, int32 SourceIndex);
+
+	//把一组规则标记为脏并加入队列
+	void MarkDirty(TObjectKey<UAbilitySystemComponent> Key, const TBitArray<>& DirtyRules);
+
+	//按依赖顺序计算一个组件上的脏规则
+	void RecomputeEntry(FEntry& Entry);
+
+	//规则对某个组件生效的缩放
+	float GetRuleScale(const FEntry& Entry, int32 RuleIndex) const { return Entry.bApplyEnemyScale ? EnemyRuleScales[RuleIndex] : 1.0f; }
+
+	//按依赖顺序排好的规则
+	TArray<FAuraCompiledDerivedRule> Rules;
+
+	//出现在规则中的来源属性，以及每个来源属性直接和间接影响的规则
+	TArray<FGameplayAttribute> SourceAttributes;
+	TArray<TBitArray<>> AffectedRulesBySource;
+
+	//规则中出现的所有属性（来源和目标），批量计算时每个组件一行按这个顺序排列
+	TArray<FGameplayAttribute> BatchAttributes;
+
+	//和Rules下标一致
+	TArray<float> EnemyRuleScales;
+
+	TSharedPtr<FBatch> PendingBatch;
+	UE::Tasks::FTask PendingBatchTask;
+	bool bBatchRequested = false;
+
+	TMap<TObjectKey<UAbilitySystemComponent>, FEntry> Entries;
+	TArray<TObjectKey<UAbilitySystemComponent>> DirtyEntries;
+
+	//写回推导结果时目标属性的变化不需要再标记（依赖已经按顺序处理）
+	bool bCommitting = false;
+
+	//批量重算的计时基准（Aura.DerivedAttributes.BatchBenchmark）需要分别调用抓取、计算和写回
+	friend struct FAuraDerivedAttributeBatchBenchmark;
+};
@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AuraEnemyAttributeStore.generated.h"
+
+class UAuraAttributeSet;
+struct FGameplayAttribute;
+
+//敌人热属性在属性仓库中的列，新增热属性时在Num之前追加，并在ToColumn中加上映射
+enum class EAuraEnemyAttributeColumn : uint8
+{
+	Health,
+	MaxHealth,
+	Mana,
+	MaxMana,
+	Num
+};
+
+/**
+ * @brief 敌人热属性的结构数组（SoA）存储：每个属性一列连续的float，同一下标属于同一个敌人
+ * @details 纯数据，不依赖Actor和属性集，遍历所有敌人的计算都写成对整列的简单循环，方便编译器向量化
+ */
+struct AURA_API FAuraEnemyAttributeColumns
+{
+	int32 Num() const { return Columns[0].Num(); }
+
+	//追加一行（所有列置0），返回下标
+	int32 Add();
+
+	//删除一行，最后一行移动到这个位置
+	void RemoveAtSwap(int32 Index);
+
+	void Reset();
+
+	float* GetColumn(EAuraEnemyAttributeColumn Column) { return Columns[(int32)Column].GetData(); }
+	const float* GetColumn(EAuraEnemyAttributeColumn Column) const { return Columns[(int32)Column].GetData(); }
+
+	//生命值<=0的行写1，其他行写0，返回生命值耗尽的数量
+	int32 ComputeDepleted(TArray<uint8>& OutDepleted) const;
+
+	//计算回复Amount之后的数值（不超过最大值，生命值耗尽的不回复），结果写入OutValues
+	void ComputeRegen(EAuraEnemyAttributeColumn ValueColumn, EAuraEnemyAttributeColumn MaxColumn, float Amount, TArray<float>& OutValues) const;
+
+	//计算每一行的生命值比例（血条），最大生命值为0时为0
+	void ComputeHealthFractions(TArray<float>& OutFractions) const;
+
+private:
+	TArray<float> Columns[(int32)EAuraEnemyAttributeColumn::Num];
+};
+
+//血条收集结果：受伤的敌人和生命值比例
+struct FAuraEnemyHealthBar
+{
+	TWeakObjectPtr<AActor> Enemy;
+	float HealthFraction = 1.0f;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnAuraEnemyHealthDepleted, AActor* /*Enemy*/);
+
+/**
+ * @brief 敌人热属性仓库
+ * @details 1. 敌人的属性集在初始化能力系统时注册，得到一个在敌人生命周期内不变的编号
+ * 2. GAS的属性数据仍然保存在UAuraAttributeSet中（复制、聚合器、属性查找都依赖它），
+ *    属性集在属性变化（服务器）和属性复制（客户端）时把当前值写入仓库，仓库是按列排列的只读镜像
+ * 3. 需要遍历所有敌人的系统（死亡检查、回复、血条）直接遍历列数组，不需要逐个访问分散在堆上的属性集
+ * 4. 回复的结果通过ASC写回属性集，GAS仍然是权威数据
+ */
+UCLASS(Config = Game)
+class AURA_API UAuraEnemyAttributeStore : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+
+	//注册属性集，复制当前值，返回编号
+	int32 Register(UAuraAttributeSet* AttributeSet);
+	void Unregister(int32 EnemyId);
+
+	bool IsValidId(int32 EnemyId) const { return IdToDense.IsValidIndex(EnemyId) && IdToDense[EnemyId] != INDEX_NONE; }
+
+	//属性集写入当前值
+	void SetValue(int32 EnemyId, EAuraEnemyAttributeColumn Column, float Value);
+	float GetValue(int32 EnemyId, EAuraEnemyAttributeColumn Column) const;
+
+	//收集所有受伤（生命值低于最大值）的敌人的血条
+	void CollectHealthBars(TArray<FAuraEnemyHealthBar>& OutHealthBars) const;
+
+	//按列访问（下标不是编号，注册/注销后会变化，只在同一帧内使用）
+	const FAuraEnemyAttributeColumns& GetColumns() const { return Columns; }
+
+	//GAS属性对应的列，不是敌人热属性时返回false
+	static bool ToColumn(const FGameplayAttribute& Attribute, EAuraEnemyAttributeColumn& OutColumn);
+
+	//服务器：敌人生命值降到0时广播一次
+	FOnAuraEnemyHealthDepleted OnEnemyHealthDepleted;
+
+	//服务器：每秒回复的生命值/魔力，为0时不回复
+	UPROPERTY(Config)
+	float HealthRegenPerSecond = 0.0f;
+
+	UPROPERTY(Config)
+	float ManaRegenPerSecond = 0.0f;
+
+	//回复的结算间隔，每次结算只有数值变化的敌人会写回属性集
+	UPROPERTY(Config)
+	float RegenInterval = 1.0f;
+
+private:
+	//生命值耗尽检查，只对刚刚耗尽的敌人广播
+	void UpdateDepleted();
+
+	//回复计算并把变化写回属性集
+	void ApplyRegen(float Interval);
+
+	//把一列新数值中有变化的行通过ASC写回属性集（把当前值的变化量加到基础值上，修改器不受影响）
+	void CommitColumn(EAuraEnemyAttributeColumn Column, const TArray<float>& NewValues);
+
+	FAuraEnemyAttributeColumns Columns;
+
+	//以下数组和列的下标一致
+	TArray<TWeakObjectPtr<UAuraAttributeSet>> DenseOwners;
+	TArray<int32> DenseToId;
+	TArray<uint8> DepletedFlags;
+
+	//编号到下标，空闲的编号为INDEX_NONE
+	TArray<int32> IdToDense;
+	TArray<int32> FreeIds;
+
+	TArray<uint8> DepletedScratch;
+	TArray<float> RegenScratch;
+	float RegenAccumulator = 0.0f;
+};
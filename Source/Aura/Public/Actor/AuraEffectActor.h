@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "GameplayEffectTypes.h"
 #include "AuraEffectActor.generated.h"
 
 
@@ -24,6 +25,59 @@ enum class EffectRemovePolicy
 	RemoveOnEndOverlap,
 	DoNotRemove
 };
+
+/**
+ * 效果Actor的一组可替换配置，对象池重新激活Actor时用它替换Actor上的效果设置
+ * 效果类都是软引用，不随地图同步加载，由UAuraAssetPreloadSubsystem异步预加载
+ */
+USTRUCT(BlueprintType)
+struct FAuraEffectActorConfig
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Applied Effects")
+	TSoftClassPtr<UGameplayEffect> InstanceGameplayEffectClass;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Applied Effects")
+	EffectApplycationPolicy InstanceEffectApplycationPolicy = EffectApplycationPolicy::DoNotApply;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Applied Effects")
+	TSoftClassPtr<UGameplayEffect> DurationGameplayEffectClass;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Applied Effects")
+	EffectApplycationPolicy DurationEffectApplycationPolicy = EffectApplycationPolicy::DoNotApply;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Applied Effects")
+	TSoftClassPtr<UGameplayEffect> InfiniteGameplayEffectClass;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Applied Effects")
+	EffectApplycationPolicy InfiniteEffectApplycationPolicy = EffectApplycationPolicy::DoNotApply;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Applied Effects")
+	EffectRemovePolicy InfinitEffectRemovePolicy = EffectRemovePolicy::RemoveOnEndOverlap;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Applied Effects")
+	bool bDestoryOnEffectRemoval = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Applied Effects")
+	float EffectLevel = 1.0f;
+};
+
+//范围模式一次批量施加的统计结果
+USTRUCT(BlueprintType)
+struct FAuraAreaEffectReport
+{
+	GENERATED_BODY()
+
+	//本次查询到并施加了效果的目标数量
+	UPROPERTY(BlueprintReadOnly, Category = "Area Effect")
+	int32 NumTargets = 0;
+
+	//本次查询和施加的总耗时（毫秒）
+	UPROPERTY(BlueprintReadOnly, Category = "Area Effect")
+	float CostMilliseconds = 0.0f;
+};
+
 UCLASS()
 class AURA_API AAuraEffectActor : public AActor
 {
@@ -33,16 +87,56 @@ public:
 
 	AAuraEffectActor();
 
+	virtual void Tick(float DeltaSeconds) override;
+	
+	/**
+	 * 销毁效果Actor：由对象池生成的Actor会被放回对象池（隐藏、关闭碰撞、网络休眠），否则直接Destroy
+	 * 蓝图中需要"销毁"效果Actor时应调用这个函数，而不是DestroyActor
+	 */
+	UFUNCTION(BlueprintCallable)
+	void DestroyEffectActor();
+	
+	//替换效果配置，清空缓存的效果规格
+	UFUNCTION(BlueprintCallable)
+	void ApplyEffectConfig(const FAuraEffectActorConfig& Config);
+	
+	//对象池调用：放回对象池前清理本Actor记录的状态
+	void ResetForPool();
+	
+	//根据是否开启范围模式启用/关闭Tick（只在服务器上Tick）
+	void RefreshAreaModeTick();
+	
+	//对象池调用：从对象池取出并重新激活后通知蓝图重置表现（特效、动画等）
+	UFUNCTION(BlueprintImplementableEvent)
+	void OnActivatedFromPool();
+	
+	//是否由对象池管理
+	bool IsPooled() const { return bPooled; }
+	void SetPooled(bool bInPooled) { bPooled = bInPooled; }
+
 protected:
 	virtual void BeginPlay() override;
+
+	//地图加载时（早于BeginPlay）提交本Actor引用的效果类进行异步预加载
+	virtual void PostInitializeComponents() override;
 	
 	
 	//效果产生后是否移除产生效果的actor
 	UPROPERTY(EditAnywhere,BlueprintReadOnly,Category = "Applied Effects")
 	bool bDestoryOnEffectRemoval = false;
 	
+	//施加效果并返回激活效果的句柄（即时效果没有激活实例，返回无效句柄）
+	//效果类是软引用，预加载还没完成时会同步加载并输出警告
+	UFUNCTION(BlueprintCallable)
+	FActiveGameplayEffectHandle ApplyEffectToTarget(AActor* TargetActor,TSoftClassPtr<UGameplayEffect> GamePlayEffectClass);
+	
+	//修改效果等级，等级变化后缓存的效果规格会在下一次施加时重建
 	UFUNCTION(BlueprintCallable)
-	void ApplyEffectToTarget(AActor* TargetActor,TSubclassOf<UGameplayEffect> GamePlayEffectClass);
+	void SetEffectLevel(float NewLevel);
+	
+	//施加效果时使用的等级
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Applied Effects")
+	float EffectLevel = 1.0f;
 	
 	//处理和血瓶等产生重叠的逻辑
 	UFUNCTION(BlueprintCallable)
@@ -54,25 +148,147 @@ protected:
 	
 	//这是一个用于实现即时游戏效果的类
 	UPROPERTY(EditAnywhere, BlueprintReadOnly,Category = "Applied Effects")
-	TSubclassOf<UGameplayEffect> InstanceGameplayEffectClass;
+	TSoftClassPtr<UGameplayEffect> InstanceGameplayEffectClass;
 	//即时效果的处理策略
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Applied Effects")
 	EffectApplycationPolicy InstanceEffectApplycationPolicy = EffectApplycationPolicy::DoNotApply;
 	
 	//这是一个具有短时间持续效果的类
 	UPROPERTY(EditAnywhere, BlueprintReadOnly,Category = "Applied Effects")
-	TSubclassOf<UGameplayEffect> DurationGameplayEffectClass;
+	TSoftClassPtr<UGameplayEffect> DurationGameplayEffectClass;
 	//短暂效果的处理策略
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Applied Effects")
 	EffectApplycationPolicy DurationEffectApplycationPolicy = EffectApplycationPolicy::DoNotApply;
 	
 	//这是一个具有无限持续效果的类
     UPROPERTY(EditAnywhere, BlueprintReadOnly,Category = "Applied Effects")
-    TSubclassOf<UGameplayEffect> InfiniteGameplayEffectClass;
+    TSoftClassPtr<UGameplayEffect> InfiniteGameplayEffectClass;
 	//无限时间效果的处理策略
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Applied Effects")
 	EffectApplycationPolicy InfiniteEffectApplycationPolicy = EffectApplycationPolicy::DoNotApply;
 	//无限效果的移除策略，只有无限效果才有
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Applied Effects")
 	EffectRemovePolicy InfinitEffectRemovePolicy = EffectRemovePolicy::RemoveOnEndOverlap;
+	
+	/**
+	 * 范围模式：不依赖蓝图的重叠事件，每隔AreaApplyInterval秒做一次球形范围查询，
+	 * 把AreaGameplayEffectClass用同一个效果规格批量施加给范围内所有拥有ASC的Actor（用于火焰地带、治疗法阵）
+	 * @note 只在服务器上执行
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Area Effect")
+	bool bEnableAreaMode = false;
+	
+	//范围模式施加的效果类
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Area Effect", meta = (EditCondition = "bEnableAreaMode"))
+	TSoftClassPtr<UGameplayEffect> AreaGameplayEffectClass;
+	
+	//范围半径（厘米）
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Area Effect", meta = (EditCondition = "bEnableAreaMode", ClampMin = "0.0"))
+	float AreaRadius = 500.0f;
+	
+	//两次范围施加的间隔（秒）
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Area Effect", meta = (EditCondition = "bEnableAreaMode", ClampMin = "0.0"))
+	float AreaApplyInterval = 0.5f;
+	
+	//范围查询的物体类型
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Area Effect", meta = (EditCondition = "bEnableAreaMode"))
+	TEnumAsByte<ECollisionChannel> AreaObjectType = ECC_Pawn;
+	
+	/**
+	 * 同一个目标两次施加即时/持续效果之间的最短间隔（秒），为0时不限制
+	 * 用于防止角色在触发范围边缘来回抖动时，同一个效果在一秒内被反复施加
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Applied Effects", meta = (ClampMin = "0.0"))
+	float ReapplyCooldown = 0.0f;
+	
+	//去重窗口（秒）：同一个目标、同一种事件（重叠/结束重叠）、同一个效果类在窗口内多次触发只处理第一次，为0时不去重
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Applied Effects", meta = (ClampMin = "0.0"))
+	float OverlapDedupWindow = 0.1f;
+	
+	//因为冷却或去重被拒绝的施加次数
+	UPROPERTY(BlueprintReadOnly, Category = "Applied Effects")
+	int32 NumRejectedApplications = 0;
+	
+	//最近一次范围施加的统计结果
+	UPROPERTY(BlueprintReadOnly, Category = "Area Effect")
+	FAuraAreaEffectReport LastAreaEffectReport;
+	
+	//执行一次范围查询并批量施加效果，返回本次的统计结果
+	UFUNCTION(BlueprintCallable, Category = "Area Effect")
+	FAuraAreaEffectReport ApplyAreaEffect();
+	
+private:
+	/**
+	 * 取得（必要时创建）某个效果类在当前等级下可以共用的效果规格
+	 * 不读取来源（属性捕获、来源标签、自定义计算）的效果对所有目标都是一样的，只创建一次并缓存，之后每次重叠直接复用
+	 * ASC在施加时会拷贝规格再计算目标相关的数据；读取来源的效果不能共用，返回空句柄
+	 */
+	const FGameplayEffectSpecHandle& GetOrCreateEffectSpec(TSubclassOf<UGameplayEffect> GamePlayEffectClass);
+	
+	//给某个目标施加用的效果规格：能共用时返回缓存的规格，否则和原来一样由目标ASC创建新的规格
+	FGameplayEffectSpecHandle MakeEffectSpec(TSubclassOf<UGameplayEffect> GamePlayEffectClass, UAbilitySystemComponent* TargetASC);
+
+	//提交当前配置中的所有效果类进行异步预加载
+	void RequestEffectClassPreload() const;
+	
+	//缓存的效果规格：效果类 → 规格（规格中记录了创建时的等级）
+	//需要对GC可见：规格的Def是效果类的CDO，同步加载的效果类只被这里引用时不能被回收
+	UPROPERTY(Transient)
+	TMap<TSubclassOf<UGameplayEffect>, FGameplayEffectSpecHandle> CachedEffectSpecs;
+	
+	//读取来源、不能共用规格的效果类
+	UPROPERTY(Transient)
+	TSet<TSubclassOf<UGameplayEffect>> UnsharedEffectClasses;
+	
+	//给目标施加无限效果并记录句柄，同一个目标已经有本Actor施加的无限效果时不会重复叠加
+	void ApplyInfiniteEffectToTarget(AActor* TargetActor);
+	
+	//移除本Actor施加在目标上的无限效果，返回是否真的移除了
+	bool RemoveInfiniteEffectFromTarget(AActor* TargetActor);
+	
+	//本Actor施加的无限效果：目标ASC → 激活效果句柄，结束重叠时按ASC直接查找移除
+	TMap<TWeakObjectPtr<UAbilitySystemComponent>, FActiveGameplayEffectHandle> ActiveInfiniteEffectHandles;
+	
+	//是否由UAuraEffectActorPool生成和回收
+	bool bPooled = false;
+	
+	//去重和冷却记录的键：目标、触发事件（重叠/结束重叠）、效果类，不同事件和不同效果互不影响
+	struct FTargetApplyKey
+	{
+		TWeakObjectPtr<AActor> Target;
+		FSoftObjectPath EffectClass;
+		EffectApplycationPolicy Event = EffectApplycationPolicy::ApplyOnOverlap;
+		
+		bool operator==(const FTargetApplyKey& Other) const
+		{
+			return Target == Other.Target && EffectClass == Other.EffectClass && Event == Other.Event;
+		}
+		
+		friend uint32 GetTypeHash(const FTargetApplyKey& Key)
+		{
+			return HashCombine(HashCombine(GetTypeHash(Key.Target), GetTypeHash(Key.EffectClass)), GetTypeHash(Key.Event));
+		}
+	};
+	
+	//最近一次触发事件和最近一次成功施加的时间
+	struct FTargetApplyRecord
+	{
+		double LastEventTime = -1.0;
+		double LastApplyTime = -1.0;
+	};
+	
+	/**
+	 * 判断本次事件能否对目标施加某个即时/持续效果（同时更新记录）
+	 * 无限效果有自己的句柄去重，不经过这里，避免结束重叠移除后再次进入时被拒绝
+	 */
+	bool CanApplyToTarget(AActor* TargetActor, EffectApplycationPolicy Event, const TSoftClassPtr<UGameplayEffect>& EffectClass);
+	
+	//清理已经过期的记录，保持表的大小只和最近触发过的目标数量相关
+	void CleanupExpiredApplyRecords(double Now);
+	
+	TMap<FTargetApplyKey, FTargetApplyRecord> TargetApplyRecords;
+	double LastApplyRecordCleanupTime = 0.0;
+	
+	//规格缓存的分配次数基准（Aura.EffectActor.SpecBenchmark）需要直接调用ApplyEffectToTarget
+	friend struct FAuraEffectActorSpecBenchmark;
 };
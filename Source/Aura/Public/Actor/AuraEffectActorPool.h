@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AuraEffectActorPool.generated.h"
+
+class AAuraEffectActor;
+struct FAuraEffectActorConfig;
+
+//同一个效果Actor类的空闲Actor列表（TMap的值不能直接是TArray的UPROPERTY，需要包一层结构体）
+USTRUCT()
+struct FAuraEffectActorPoolBucket
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<TObjectPtr<AAuraEffectActor>> FreeActors;
+};
+
+/**
+ * @brief 效果Actor对象池（每个World一个）
+ * @details 血瓶、陷阱等效果Actor在"销毁"时不再真正Destroy，而是隐藏、关闭碰撞和Tick、进入网络休眠后放回对象池；
+ * 之后需要同类Actor时直接从对象池取出，换上新的位置和效果配置重新激活。
+ * 掉落密集的波次中可以避免大量Spawn/Destroy带来的卡顿和GC压力
+ * @note 只在服务器上生成和回收，客户端通过Actor的复制状态（隐藏、碰撞、休眠）同步
+ */
+UCLASS()
+class AURA_API UAuraEffectActorPool : public UWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	/**
+	 * 取出（没有空闲时生成）一个效果Actor并激活
+	 * @param EffectActorClass 效果Actor类
+	 * @param SpawnTransform 激活后的位置
+	 * @param Config 激活后使用的效果配置，为空时保留Actor上原来的配置
+	 */
+	AAuraEffectActor* AcquireEffectActor(TSubclassOf<AAuraEffectActor> EffectActorClass, const FTransform& SpawnTransform, const FAuraEffectActorConfig* Config = nullptr);
+
+	//蓝图版本：总是使用传入的效果配置
+	UFUNCTION(BlueprintCallable, Category = "Effect Actor Pool", meta = (DisplayName = "Acquire Effect Actor"))
+	AAuraEffectActor* K2_AcquireEffectActor(TSubclassOf<AAuraEffectActor> EffectActorClass, const FTransform& SpawnTransform, const FAuraEffectActorConfig& Config);
+
+	//把效果Actor放回对象池（隐藏、关闭碰撞和Tick、网络休眠）
+	UFUNCTION(BlueprintCallable, Category = "Effect Actor Pool")
+	void ReleaseEffectActor(AAuraEffectActor* EffectActor);
+
+	//预先生成一批空闲Actor，避免第一波掉落时集中生成
+	UFUNCTION(BlueprintCallable, Category = "Effect Actor Pool")
+	void Prewarm(TSubclassOf<AAuraEffectActor> EffectActorClass, int32 Count);
+
+	//某个类当前空闲的Actor数量
+	UFUNCTION(BlueprintPure, Category = "Effect Actor Pool")
+	int32 GetNumFreeActors(TSubclassOf<AAuraEffectActor> EffectActorClass) const;
+
+private:
+	//生成一个由对象池管理的效果Actor
+	AAuraEffectActor* SpawnPooledActor(TSubclassOf<AAuraEffectActor> EffectActorClass, const FTransform& SpawnTransform);
+
+	//休眠/激活Actor的通用状态
+	static void DeactivateActor(AAuraEffectActor* EffectActor);
+	static void ActivateActor(AAuraEffectActor* EffectActor, const FTransform& SpawnTransform);
+
+	UPROPERTY()
+	TMap<TSubclassOf<AAuraEffectActor>, FAuraEffectActorPoolBucket> Buckets;
+};
@@ -17,11 +17,16 @@ class AURA_API AAuraCharacter : public AAuraCharacterBase
 public:
 	virtual void PossessedBy(AController* NewController) override;
 	virtual  void OnRep_PlayerState() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 public:
 	AAuraCharacter();
 	
 	
 private:
+	//可以重复调用：ActorInfo和Overlay只在PlayerState/控制器/HUD变化时重新初始化
 	void InitAbilitySystemInfo();
+
+	//当前持有Overlay引用的HUD
+	TWeakObjectPtr<AAuraHUD> OverlayHUD;
 	
 };
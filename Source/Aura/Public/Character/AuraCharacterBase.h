@@ -20,9 +20,22 @@ public:
 	
 	virtual UAbilitySystemComponent* GetAbilitySystemComponent() const override;
 	UAttributeSet* GetAttributeSet() const{return AttributeSet;}
+
+	//记录一次战斗事件（受到效果、发起攻击），重要性子系统在CombatTimeout内把角色当作战斗中
+	void MarkInCombat();
+	bool IsInCombat() const;
+
+	//最近一次战斗事件之后多久仍然算作战斗中
+	UPROPERTY(EditDefaultsOnly, Category = "Significance")
+	float CombatTimeout = 5.0f;
+
+	//角色等级，初始属性按等级从默认值表中取值
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Attributes")
+	int32 CharacterLevel = 1;
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	UPROPERTY(EditAnywhere, category = "combat")
 	TObjectPtr<USkeletalMeshComponent> Weapon;
@@ -34,4 +47,14 @@ protected:
 	//敌人的属性集组件
 	UPROPERTY()
 	TObjectPtr<UAttributeSet> AttributeSet;
+
+	//属性默认值表（UAuraAttributeDefaultsSubsystem）中的行名，为空时使用属性集构造时的默认值
+	UPROPERTY(EditDefaultsOnly, Category = "Attributes")
+	FName AttributeDefaultsName;
+
+	//服务器上按AttributeDefaultsName和CharacterLevel一次性写入初始属性，再注册次级属性推导，能力系统组件初始化后调用
+	void InitializeDefaultAttributes() const;
+private:
+	//最近一次战斗事件的世界时间
+	double LastCombatTime = -UE_BIG_NUMBER;
 };
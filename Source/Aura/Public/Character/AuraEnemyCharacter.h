@@ -7,6 +7,25 @@
 #include "Interaction/EnemyInterface.h"
 #include "AuraEnemyCharacter.generated.h"
 
+//能力系统还没有创建时代替属性集的默认属性记录，只有四个浮点数
+USTRUCT(BlueprintType)
+struct FAuraDormantVitals
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	float Health = 50.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	float MaxHealth = 100.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	float Mana = 10.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	float MaxMana = 50.0f;
+};
+
 /**
  * 
  */
@@ -18,11 +37,46 @@ public:
 	/** enemy Interfacce**/
 	virtual void HightLightEnemy() override;
 	virtual void UnHightLightEnemy() override;
+	virtual void ApplyHighlightRenderState(bool bHighlighted) override;
 	/** end enemy interface **/
+
+	virtual void OnSubobjectCreatedFromReplication(UObject* NewSubobject) override;
+
+	//确保能力系统组件和属性集已经创建并初始化，只在服务器上创建
+	//延迟创建模式下GetAbilitySystemComponent不会创建（没有创建时返回空），需要在确定敌人参与战斗的地方显式调用：
+	//施加效果（AAuraEffectActor）、被悬停（AAuraPlayerController）、仇恨（AI蓝图）
+	UFUNCTION(BlueprintCallable, Category = "GAS")
+	void ActivateAbilitySystem();
+
+	//能力系统是否已经创建
+	UFUNCTION(BlueprintPure, Category = "GAS")
+	bool IsAbilitySystemActive() const { return AbilitySysteamComponent != nullptr; }
+
+	const FAuraDormantVitals& GetDormantVitals() const { return DormantVitals; }
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	//能力系统创建之前使用的默认属性，创建时用它初始化属性集
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GAS")
+	FAuraDormantVitals DormantVitals;
 public:
 	AAuraEnemyCharacter();
+
+	//是否延迟创建能力系统组件和属性集，读取DefaultGame.ini中[/Script/Aura.AuraEnemyCharacter] bLazyAbilitySystem
+	static bool IsLazyAbilitySystemEnabled();
+private:
+	//创建并复制能力系统组件和属性集（构造函数或延迟创建时调用）
+	void CreateAbilitySystem(bool bAsDefaultSubobject);
+
+	//给组件设置敌人用的复制配置并初始化ActorInfo
+	void InitAbilitySystem();
+
+	//把属性集注册到属性仓库（UAuraEnemyAttributeStore），开始游戏之后才注册
+	void BindAttributeStore();
+
+	//构造时记录的延迟创建开关，保证CDO和实例一致
+	bool bLazyAbilitySystem = false;
 };
 
 
@@ -0,0 +1,144 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AuraSignificanceSubsystem.generated.h"
+
+class AAuraCharacterBase;
+
+//角色的重要性等级，数值越小越重要
+UENUM(BlueprintType)
+enum class EAuraSignificance : uint8
+{
+	Critical,	//本地控制的角色、近处可见的角色
+	High,		//中距离可见或者战斗中的角色
+	Medium,		//远处可见的角色
+	Low,		//不可见但还在范围内的角色
+	Culled,		//很远且不可见，只保留最低限度的更新
+	Num UMETA(Hidden)
+};
+
+//每个重要性等级对应的更新设置
+USTRUCT(BlueprintType)
+struct FAuraSignificanceSettings
+{
+	GENERATED_BODY()
+
+	//Actor和移动组件的Tick间隔，0表示每帧
+	UPROPERTY(EditAnywhere, Config)
+	float TickInterval = 0.0f;
+
+	//骨骼网格体（动画）的Tick间隔，0表示每帧
+	UPROPERTY(EditAnywhere, Config)
+	float AnimTickInterval = 0.0f;
+
+	//是否开启Actor和组件的Tick，关闭时只有移动组件保留Tick（服务器还要驱动移动）
+	UPROPERTY(EditAnywhere, Config)
+	bool bEnableComponentTicks = true;
+};
+
+/**
+ * @brief 角色重要性子系统
+ * @details 按照到玩家视点的距离、最近是否被渲染、是否在战斗中给每个角色打分，分到不同的重要性等级，
+ * 再按等级设置Actor Tick间隔、骨骼网格体（动画）Tick间隔、移动组件Tick间隔，以及是否开启其他组件的Tick
+ * 评分每UpdateInterval秒做一次，等级没变的角色不会重新设置
+ * Aura.Significance.Enabled 0 可以关闭调度（所有角色恢复每帧更新），用来对比开启前后 stat Aura / stat game 的耗时
+ */
+UCLASS(Config = Game)
+class AURA_API UAuraSignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	UAuraSignificanceSubsystem();
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterCharacter(AAuraCharacterBase* Character);
+	void UnregisterCharacter(AAuraCharacterBase* Character);
+
+	UFUNCTION(BlueprintPure, Category = "Significance")
+	EAuraSignificance GetSignificance(const AAuraCharacterBase* Character) const;
+
+	//重新评分的间隔（秒）
+	UPROPERTY(Config)
+	float UpdateInterval = 0.25f;
+
+	//小于这个距离并且可见为Critical
+	UPROPERTY(Config)
+	float CriticalDistance = 1500.0f;
+
+	//小于这个距离并且可见为High
+	UPROPERTY(Config)
+	float HighDistance = 3000.0f;
+
+	//超过这个距离并且不可见为Culled
+	UPROPERTY(Config)
+	float CullDistance = 8000.0f;
+
+	//判断“最近被渲染”的时间容差
+	UPROPERTY(Config)
+	float RecentlyRenderedTolerance = 0.5f;
+
+	//每个重要性等级的更新设置，下标是EAuraSignificance
+	UPROPERTY(Config)
+	FAuraSignificanceSettings LevelSettings[5];
+
+private:
+	//调度开始前的一份Tick设置，恢复时原样写回
+	struct FSavedTickState
+	{
+		bool bTickEnabled = true;
+		float TickInterval = 0.0f;
+
+		//骨骼网格体的EVisibilityBasedAnimTickOption
+		uint8 VisibilityBasedAnimTickOption = 0;
+	};
+
+	//一个注册的角色：当前等级，以及第一次调度时记录的角色和组件原来的Tick设置
+	struct FTrackedCharacter
+	{
+		EAuraSignificance Significance = EAuraSignificance::Critical;
+
+		bool bHasSavedActorTick = false;
+		FSavedTickState SavedActorTick;
+
+		//组件第一次被调度时记录，之后才添加的组件（例如延迟创建的能力系统组件）在第一次遇到时记录
+		TMap<TWeakObjectPtr<UActorComponent>, FSavedTickState> SavedComponentTicks;
+	};
+
+	//所有玩家的视点：本地玩家和（服务器上）远程玩家分开，远程玩家的画面不在本机渲染
+	struct FViewLocations
+	{
+		TArray<FVector, TInlineAllocator<4>> Local;
+		TArray<FVector, TInlineAllocator<4>> Remote;
+	};
+
+	/**
+	 * 给角色评分
+	 * 渲染测试只代表本地玩家的画面；监听服务器上远程玩家HighDistance以内的角色不做渲染测试，当作可见只按距离评分，
+	 * 否则远程客户端身边的敌人会被评为Low，服务器降低它的移动更新频率，客户端看到的AI移动一卡一卡
+	 */
+	EAuraSignificance EvaluateSignificance(const AAuraCharacterBase* Character, const FViewLocations& ViewLocations) const;
+
+	/**
+	 * 把等级对应的设置应用到角色上
+	 * 原本关闭Tick的组件（能力系统组件、GameplayTasks等）不会被开启，原本的Tick间隔作为最小间隔
+	 */
+	void ApplySignificance(AAuraCharacterBase* Character, FTrackedCharacter& Tracked, EAuraSignificance Significance) const;
+
+	//关闭调度时把记录的Tick设置原样写回，并清空记录
+	void RestoreDefaults(AAuraCharacterBase* Character, FTrackedCharacter& Tracked) const;
+
+	//收集所有玩家的视点位置（客户端是本地玩家，服务器是所有玩家）
+	void GatherViewLocations(FViewLocations& OutViewLocations) const;
+
+	TMap<TWeakObjectPtr<AAuraCharacterBase>, FTrackedCharacter> Characters;
+
+	float TimeSinceLastUpdate = 0.0f;
+
+	//上一次Tick时调度是否开启，用于检测控制台变量的切换
+	bool bWasEnabled = true;
+};
@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Aura/Aura.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AuraAssetPreloadSubsystem.generated.h"
+
+struct FStreamableHandle;
+
+/**
+ * @brief 地图加载阶段的异步预加载
+ * @details UI类、效果类都改成了软引用，不再随地图同步加载
+ * 1. 世界初始化时异步加载DefaultGame.ini中配置的类（例如Overlay控件和控制器）
+ * 2. 效果Actor、HUD在PostInitializeComponents（地图加载时，早于BeginPlay）提交自己引用的类
+ * 3. 使用时通过ResolveClass取得，还没加载完成时同步加载并输出警告，说明预加载配置漏掉了这个类
+ * 4. 游戏世界的第一帧结束时输出一次加载计时：从世界初始化到BeginPlay（地图加载）和到第一帧的耗时、
+ *    预加载完成的数量、同步加载的次数，可以用-nullrhi无头启动地图对比改动前后的数据
+ */
+UCLASS(Config = Game)
+class AURA_API UAuraAssetPreloadSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	//异步加载一组资源，已经请求过的路径会被忽略，加载完成的资源在世界销毁前保持引用
+	void RequestPreload(TConstArrayView<FSoftObjectPath> Paths);
+
+	//便捷函数：找到WorldContext所在世界的子系统并请求预加载
+	static void RequestPreloadFor(const UObject* WorldContext, TConstArrayView<FSoftObjectPath> Paths);
+
+	//取得软引用的类：已经加载时直接返回，否则同步加载并输出警告
+	template<typename T>
+	static TSubclassOf<T> ResolveClass(const TSoftClassPtr<T>& SoftClass)
+	{
+		if (SoftClass.IsNull())
+		{
+			return nullptr;
+		}
+		if (UClass* LoadedClass = SoftClass.Get())
+		{
+			return LoadedClass;
+		}
+		NotifySynchronousLoad(SoftClass.ToSoftObjectPath());
+		return SoftClass.LoadSynchronous();
+	}
+
+	//客户端（非专用服务器）在世界初始化时预加载的类，例如Overlay控件和控制器
+	UPROPERTY(Config)
+	TArray<FSoftClassPath> ClientPreloadClasses;
+
+	//所有端在世界初始化时预加载的类
+	UPROPERTY(Config)
+	TArray<FSoftClassPath> PreloadClasses;
+
+private:
+	//输出同步加载的警告并计数
+	static void NotifySynchronousLoad(const FSoftObjectPath& Path);
+
+	//第一帧结束时输出加载计时
+	void OnFirstPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	TSet<FSoftObjectPath> RequestedPaths;
+
+	TArray<TSharedPtr<FStreamableHandle>> PreloadHandles;
+
+	//加载计时：世界初始化的时间、初始化时的同步加载次数、BeginPlay距离初始化的秒数
+	double InitializeTime = 0.0;
+	int32 InitialSynchronousLoads = 0;
+	double BeginPlaySeconds = 0.0;
+	FDelegateHandle FirstTickHandle;
+
+	//所有世界累计的同步加载次数
+	static int32 SynchronousLoadCount;
+};
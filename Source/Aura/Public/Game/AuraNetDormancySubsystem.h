@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AuraNetDormancySubsystem.generated.h"
+
+/**
+ * @brief 服务器上自动管理敌人和效果Actor的网络休眠
+ * @details 1. 注册的Actor在QuietPeriod秒内没有活动（属性变化、被施加效果、移动）就进入DORM_DormantAll，不再参与每次网络更新的属性比较
+ * 2. 有活动时调用NotifyActivity，立即唤醒（FlushNetDormancy后设为DORM_Awake），保证这一帧的变化能发出去
+ * 3. 移动通过每帧比较位置检测，休眠的Actor被移动时在同一帧的网络更新之前唤醒
+ * stat Aura 中可以看到休眠Actor数量和估算节省的网络更新检查次数
+ */
+UCLASS(Config = Game)
+class AURA_API UAuraNetDormancySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	//开始管理Actor的休眠（只在服务器上生效），重复注册无影响
+	void RegisterActor(AActor* Actor);
+
+	//停止管理Actor的休眠，不修改它当前的休眠状态（对象池会自己设置）
+	void UnregisterActor(AActor* Actor);
+
+	//Actor有需要复制的活动：休眠中则立即唤醒，并重新开始计算安静时间
+	void NotifyActivity(AActor* Actor);
+
+	//便捷函数：找到Actor所在世界的子系统并通知活动
+	static void NotifyActorActivity(AActor* Actor);
+
+	//多久没有活动后进入休眠（秒）
+	UPROPERTY(Config)
+	float QuietPeriod = 5.0f;
+
+	//位置变化超过这个距离算作移动
+	UPROPERTY(Config)
+	float MovementTolerance = 1.0f;
+
+private:
+	struct FDormancyEntry
+	{
+		FVector LastLocation = FVector::ZeroVector;
+		double LastActivityTime = 0.0;
+		bool bDormant = false;
+	};
+
+	//唤醒Actor
+	void WakeActor(AActor* Actor, FDormancyEntry& Entry);
+
+	TMap<TWeakObjectPtr<AActor>, FDormancyEntry> ManagedActors;
+};
@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "AuraReplicationGraph.generated.h"
+
+class UReplicationGraphNode_ActorList;
+class UReplicationGraphNode_GridSpatialization2D;
+
+//Actor类在复制图中的路由方式
+enum class EAuraClassRepNodeMapping : uint8
+{
+	NotRouted,					//不进入任何全局节点（PlayerController、PlayerState由专门的节点处理）
+	RelevantAllConnections,		//对所有连接始终相关（GameState等）
+	Spatialize_Static,			//放入空间网格，不会移动
+	Spatialize_Dynamic,			//放入空间网格，每帧更新位置（敌人、玩家角色）
+	Spatialize_Dormancy,		//休眠时按静态处理，唤醒后按动态处理（效果Actor，对象池激活时会被移动）
+};
+
+/**
+ * @brief 每个连接自己的节点：连接的PlayerController、Pawn、ViewTarget，以及连接拥有的PlayerState
+ * @details 玩家的能力系统组件挂在PlayerState上并使用Mixed复制模式，GE只复制给拥有者，
+ * 拥有者的PlayerState走这个节点按全频率复制，其他连接的PlayerState走限频节点
+ */
+UCLASS()
+class AURA_API UAuraReplicationGraphNode_OwnerOnly : public UReplicationGraphNode_AlwaysRelevant_ForConnection
+{
+	GENERATED_BODY()
+public:
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+private:
+	FActorRepListRefView OwnedActorList;
+};
+
+/**
+ * @brief Aura的复制图
+ * @details 替换默认的“每个Actor对每个连接判断相关性”的复制路径（开销是Actor数×连接数）：
+ * 1. 敌人、玩家角色、效果Actor按位置放进二维空间网格，连接只收集视点附近格子里的Actor
+ * 2. PlayerState对所有连接相关，但每帧只复制有限个（UReplicationGraphNode_PlayerStateFrequencyLimiter）
+ * 3. PlayerController和拥有者的PlayerState走每个连接自己的节点（UAuraReplicationGraphNode_OwnerOnly）
+ * 在DefaultEngine.ini的[/Script/OnlineSubsystemUtils.IpNetDriver] ReplicationDriverClassName中启用
+ */
+UCLASS(Transient, Config = Engine)
+class AURA_API UAuraReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+public:
+	UAuraReplicationGraph();
+
+	virtual void ResetGameWorldState() override;
+	virtual void InitGlobalActorClassSettings() override;
+	virtual void InitGlobalGraphNodes() override;
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+
+	/**
+	 * 运行时修改单个Actor的复制频率
+	 * 复制图在Actor加入时按类的CDO设置复制间隔，之后不再读取Actor的NetUpdateFrequency，
+	 * 需要动态调整频率的Actor（PlayerState）通过这里写入复制图中这个Actor自己的设置；没有使用复制图时什么都不做
+	 */
+	static void SetActorReplicationFrequency(AActor* Actor, float NetUpdateFrequency);
+
+	//空间网格的格子大小
+	UPROPERTY(Config)
+	float GridCellSize = 10000.0f;
+
+	//空间网格的原点偏移，地图的最小坐标应该大于这个值
+	UPROPERTY(Config)
+	FVector2D SpatialBias = FVector2D(-200000.0f, -200000.0f);
+
+	//对所有连接始终相关的Actor
+	UPROPERTY()
+	TObjectPtr<UReplicationGraphNode_ActorList> AlwaysRelevantNode;
+
+	UPROPERTY()
+	TObjectPtr<UReplicationGraphNode_GridSpatialization2D> GridNode;
+
+private:
+	//类的路由方式，没有显式设置的类按CDO的属性推断一次后缓存
+	EAuraClassRepNodeMapping GetMappingPolicy(UClass* Class);
+
+	//按类的CDO设置复制频率和裁剪距离
+	void InitClassReplicationInfo(UClass* Class, float DistancePriorityScale);
+
+	TClassMap<EAuraClassRepNodeMapping> ClassRepNodePolicies;
+};
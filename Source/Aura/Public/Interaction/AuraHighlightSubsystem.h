@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AuraHighlightSubsystem.generated.h"
+
+//高亮来源：同一个敌人可以同时因为多个原因高亮，所有来源都移除后才取消高亮
+UENUM(BlueprintType)
+enum class EAuraHighlightSource : uint8
+{
+	Hover,		//鼠标悬停
+	Selection,	//框选/多选
+	Area,		//范围悬停（例如技能范围预览）
+};
+
+/**
+ * @brief 敌人高亮管理子系统（客户端）
+ * @details 1. 高亮请求（悬停、多选、范围悬停）只记录期望状态，不立即修改渲染状态
+ * 2. 每帧Tick时统一提交：只对期望状态和已提交状态不同的Actor调用IEnemyInterface::ApplyHighlightRenderState
+ * 3. 同一帧内的开→关→开等来回切换不会产生任何渲染状态修改
+ * 框选上百个敌人时，每个敌人每帧最多标记一次渲染状态为脏
+ */
+UCLASS()
+class AURA_API UAuraHighlightSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	//专用服务器不需要高亮
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	//给Actor添加一个高亮来源
+	UFUNCTION(BlueprintCallable, Category = "Highlight")
+	void AddHighlightSource(AActor* Actor, EAuraHighlightSource Source);
+
+	//移除Actor的一个高亮来源
+	UFUNCTION(BlueprintCallable, Category = "Highlight")
+	void RemoveHighlightSource(AActor* Actor, EAuraHighlightSource Source);
+
+	//用一组Actor替换某个来源当前高亮的全部Actor（多选、框选）
+	UFUNCTION(BlueprintCallable, Category = "Highlight")
+	void SetHighlightSourceActors(EAuraHighlightSource Source, const TArray<AActor*>& Actors);
+
+	//范围悬停：高亮范围内的所有敌人（替换上一次的范围悬停结果），半径为0时清空
+	UFUNCTION(BlueprintCallable, Category = "Highlight")
+	void SetAreaHover(const FVector& Center, float Radius);
+
+	//Actor当前是否被请求高亮（期望状态，可能还没有提交）
+	UFUNCTION(BlueprintPure, Category = "Highlight")
+	bool IsHighlightRequested(const AActor* Actor) const;
+
+private:
+	//把本帧变化过的Actor的期望状态提交到渲染状态
+	void CommitHighlightChanges();
+
+	//修改某个Actor的来源掩码，并记录为待提交
+	void SetSourceBit(AActor* Actor, EAuraHighlightSource Source, bool bEnabled);
+
+	struct FHighlightState
+	{
+		//当前所有高亮来源的掩码，非0表示需要高亮
+		uint8 SourceMask = 0;
+		//已经提交到渲染状态的高亮状态
+		bool bCommitted = false;
+	};
+
+	TMap<TWeakObjectPtr<AActor>, FHighlightState> HighlightStates;
+
+	//本帧需要检查的Actor
+	TSet<TWeakObjectPtr<AActor>> PendingActors;
+};
@@ -25,4 +25,7 @@ public:
 	//对应的敌人完成这两个接口，playercontroller会检测鼠标下的Actor属性，同时会检测这两个接口是否重写，如果重写就会调用这两个接口，对于敌人来说，调用接口就会让敌人高亮
 	virtual void HightLightEnemy() = 0;
 	virtual void UnHightLightEnemy() = 0;
+	
+	//真正修改渲染状态（自定义深度）的接口，由高亮子系统在每帧统一提交时调用，其他逻辑不要直接调用
+	virtual void ApplyHighlightRenderState(bool bHighlighted) = 0;
 };
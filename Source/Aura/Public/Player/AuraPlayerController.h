@@ -20,6 +20,13 @@ class AURA_API AAuraPlayerController : public APlayerController
 public:
 	AAuraPlayerController();
 	virtual void PlayerTick(float DeltaTime) override;
+	
+	//服务器上记录的该玩家当前悬停的敌人（用于敌人属性按连接复制的策略判断）
+	AActor* GetHoveredEnemy() const { return HoveredEnemy.Get(); }
+	
+	//服务器接受的悬停距离：客户端上报的敌人离该玩家的角色超过这个距离时忽略
+	UPROPERTY(EditDefaultsOnly, Category = "Targeting")
+	float MaxHoveredEnemyDistance = 5000.0f;
 protected:
 	virtual void BeginPlay() override;
 	virtual void SetupInputComponent() override;//配置输入组件，将输入动作（如移动）与对应的处理函数绑定，是输入系统初始化的关键步骤。  
@@ -33,11 +40,22 @@ private:
 	
 	void Move(const FInputActionValue& InputActionValue);//处理输入数据的函数
 	
-	//这个函数由玩家操作器每帧调用，检测鼠标下的actor是否重写了高亮接口，并且对高亮接口进行调用
+	//这个函数由玩家操作器每帧调用，从目标检测子系统取得鼠标下的actor，检测是否重写了高亮接口，并且对高亮接口进行调用
 	void CursorTrace();
 	
 	//Tick检测中上一帧，鼠标下的actor类型
 	TObjectPtr<IEnemyInterface> ThisActor;
 	//Tick检测中这一帧率，鼠标下的actor类型
 	TObjectPtr<IEnemyInterface> LastActor;
+	
+	//悬停的敌人只在客户端知道，变化时通过这个RPC通知服务器
+	//只在变化时发送，丢失后不会重发，而且服务器要在这里创建敌人的能力系统，所以是可靠RPC
+	UFUNCTION(Server, Reliable)
+	void ServerSetHoveredEnemy(AActor* Enemy);
+	
+	//服务器：客户端上报的悬停敌人是否可信（对该玩家网络相关，并且离该玩家的角色足够近）
+	bool IsValidHoveredEnemy(const AActor* Enemy) const;
+	
+	//当前悬停的敌人，服务器和本地玩家上有效
+	TWeakObjectPtr<AActor> HoveredEnemy;
 };
@@ -4,11 +4,14 @@
 
 #include "CoreMinimal.h"
 #include "AbilitySystemInterface.h"
+#include "GameplayEffectTypes.h"
 #include "GameFramework/PlayerState.h"
 #include "AuraPlayerState.generated.h"
 
 class UabilitySystemComponent;
 class UAttributeSet;
+struct FActiveGameplayEffect;
+struct FGameplayEffectSpec;
 /**
  * 
  */
@@ -20,7 +23,32 @@ public:
 	AAuraPlayerState();
 	virtual UAbilitySystemComponent* GetAbilitySystemComponent() const override;
 	UAttributeSet* GetAttributeSet() const{return AttributeSet;}
+
+	//服务器：能力系统有变化（属性变化、效果添加/移除）时调用，恢复高频更新并立即发送一次
+	void NotifyReplicationActivity();
+
+	//服务器：属性集是否已经按默认值表初始化过（PlayerState跨重生保留，初始属性只写一次）
+	bool HasInitializedDefaultAttributes() const { return bDefaultAttributesInitialized; }
+	void MarkDefaultAttributesInitialized() { bDefaultAttributesInitialized = true; }
 protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	//有复制活动时的网络更新频率
+	UPROPERTY(EditDefaultsOnly, Category = "Replication")
+	float ActiveNetUpdateFrequency = 100.0f;
+
+	//空闲时的网络更新频率
+	UPROPERTY(EditDefaultsOnly, Category = "Replication")
+	float IdleNetUpdateFrequency = 2.0f;
+
+	//最后一次复制活动之后多久进入空闲
+	UPROPERTY(EditDefaultsOnly, Category = "Replication")
+	float IdleDelay = 2.0f;
+
+	//空闲时是否进入网络休眠（完全不参与复制），有活动时唤醒
+	UPROPERTY(EditDefaultsOnly, Category = "Replication")
+	bool bDormantWhenIdle = false;
 	
 	//玩家的能力系统组件
 	UPROPERTY()
@@ -29,4 +57,23 @@ protected:
 	//玩家的属性集组件
 	UPROPERTY()
 	TObjectPtr<UAttributeSet> AttributeSet;
+
+private:
+	//空闲计时结束：没有持续中的效果时降低更新频率或进入休眠
+	void OnIdleTimerElapsed();
+
+	//修改网络更新频率（同时写入复制图中这个PlayerState的设置）
+	void SetReplicationFrequency(float Frequency);
+
+	void OnActiveGameplayEffectAdded(UAbilitySystemComponent* Target, const FGameplayEffectSpec& Spec, FActiveGameplayEffectHandle Handle);
+	void OnActiveGameplayEffectRemoved(const FActiveGameplayEffect& Effect);
+
+	//能力系统上是否还有持续时间有限的效果（这些效果会继续修改属性或即将过期）
+	bool HasActiveDurationEffects() const;
+
+	FTimerHandle IdleTimerHandle;
+
+	bool bReplicationIdle = false;
+
+	bool bDefaultAttributesInitialized = false;
 };
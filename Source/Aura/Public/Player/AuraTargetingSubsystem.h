@@ -0,0 +1,128 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/HitResult.h"
+#include "Subsystems/LocalPlayerSubsystem.h"
+#include "UObject/WeakInterfacePtr.h"
+#include "AuraTargetingSubsystem.generated.h"
+
+class IEnemyInterface;
+
+/**
+ * 鼠标下的目标（每帧最多检测一次，所有系统共用）
+ */
+USTRUCT(BlueprintType)
+struct FAuraCursorTarget
+{
+	GENERATED_BODY()
+
+	//完整的检测结果
+	UPROPERTY(BlueprintReadOnly, Category = "Targeting")
+	FHitResult HitResult;
+
+	//命中的Actor，没有命中时为空
+	UPROPERTY(BlueprintReadOnly, Category = "Targeting")
+	TObjectPtr<AActor> HitActor = nullptr;
+
+	//命中位置（地面或Actor表面）
+	UPROPERTY(BlueprintReadOnly, Category = "Targeting")
+	FVector Location = FVector::ZeroVector;
+
+	//是否命中了物体
+	UPROPERTY(BlueprintReadOnly, Category = "Targeting")
+	bool bBlockingHit = false;
+
+	//命中的Actor实现了IEnemyInterface时指向它，否则为空（只在C++中使用）
+	TWeakInterfacePtr<IEnemyInterface> Enemy;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnAuraCursorTargetChangedSignature, const FAuraCursorTarget&, CursorTarget);
+
+/**
+ * @brief 本地玩家的目标检测子系统
+ * @details 鼠标下的检测每帧最多执行一次，结果发布给所有需要鼠标目标的系统（敌人高亮、技能瞄准、UI）：
+ * 1. 任何系统调用GetCursorTarget时，如果本帧还没有检测过就检测一次，之后的调用直接返回同一个结果
+ * 2. 支持同步检测（GetHitResultUnderCursor）和异步检测（本帧发起、下一帧取结果）
+ * 3. 鼠标、相机、命中Actor都没有变化时复用上一次的结果（悬停缓存），不发射线
+ * 不论有多少个系统使用鼠标目标，每帧的射线数量都不变
+ */
+UCLASS(Config = Game)
+class AURA_API UAuraTargetingSubsystem : public ULocalPlayerSubsystem
+{
+	GENERATED_BODY()
+public:
+	/**
+	 * 取得本帧的鼠标目标（本帧第一次调用时执行检测）
+	 * 异步模式下结果来自上一帧发起的射线；悬停缓存有效时是上一次检测的结果
+	 */
+	const FAuraCursorTarget& GetCursorTarget();
+
+	//蓝图版本，返回拷贝
+	UFUNCTION(BlueprintCallable, Category = "Targeting", meta = (DisplayName = "Get Cursor Target"))
+	FAuraCursorTarget K2_GetCursorTarget() { return GetCursorTarget(); }
+
+	//本帧是否得到了新的检测结果（false表示本帧跳过了检测或者异步结果还没准备好，目标和上一次一样）
+	bool WasRefreshedThisFrame() const { return LastRefreshFrame == GFrameCounter; }
+
+	//命中的Actor发生变化时广播
+	UPROPERTY(BlueprintAssignable, Category = "Targeting")
+	FOnAuraCursorTargetChangedSignature OnCursorTargetChanged;
+
+	/**
+	 * 是否使用异步鼠标射线检测
+	 * 开启后射线在本帧发起、下一帧取结果，不再在游戏线程上同步等待复杂碰撞的检测；目标会晚一帧更新
+	 * 关闭时使用同步检测
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Targeting")
+	bool bUseAsyncCursorTrace = true;
+
+	//是否启用悬停缓存：状态没有变化的帧直接复用上一次的检测结果，不再发射线
+	UPROPERTY(Config, EditAnywhere, Category = "Targeting")
+	bool bUseCursorHoverCache = true;
+
+	//缓存的最长有效时间（秒）：鼠标静止时也按这个间隔重新检测一次，保证走到鼠标下的敌人能被发现
+	UPROPERTY(Config, EditAnywhere, Category = "Targeting", meta = (ClampMin = "0.0"))
+	float HoverCacheMaxAge = 0.2f;
+
+private:
+	//本帧执行一次检测（每帧只会真正执行一次）
+	void UpdateCursorTarget();
+
+	/**
+	 * 获取鼠标下的检测结果
+	 * 同步模式：直接调用GetHitResultUnderCursor；异步模式：取回上一帧发起的异步射线结果，并按需为下一帧发起新的射线
+	 * @return 本帧是否拿到了检测结果
+	 */
+	bool GetCursorHitResult(APlayerController* PlayerController, FHitResult& OutHitResult, bool bIssueNewTrace);
+
+	/**
+	 * 悬停缓存是否仍然有效：鼠标位置、相机位置/朝向、上一次命中Actor的位置都没有变化，并且缓存没有超过HoverCacheMaxAge
+	 * 缓存失效时会记录当前的状态，作为下一次比较的基准
+	 */
+	bool IsCursorHoverCacheValid(APlayerController* PlayerController);
+
+	//需要UPROPERTY让GC看到其中的HitActor，命中的Actor被销毁后引用会被清空
+	UPROPERTY()
+	FAuraCursorTarget CursorTarget;
+
+	//上一次执行检测逻辑的帧和得到新结果的帧
+	uint64 LastUpdateFrame = 0;
+	uint64 LastRefreshFrame = 0;
+
+	//上一帧发起、还没取回结果的异步射线
+	FTraceHandle PendingCursorTraceHandle;
+
+	//上一次检测时的状态快照
+	bool bHasHoverCache = false;
+	FVector2D CachedMousePosition = FVector2D::ZeroVector;
+	FVector CachedViewLocation = FVector::ZeroVector;
+	FRotator CachedViewRotation = FRotator::ZeroRotator;
+	FTransform CachedHitActorTransform;
+	double CachedHoverTime = 0.0;
+
+	//悬停缓存的统计：总帧数和跳过检测的帧数，用于计算跳过率
+	uint64 NumCursorTraceFrames = 0;
+	uint64 NumCursorTraceSkips = 0;
+};
@@ -33,7 +33,19 @@ public:
 	
 	UOverlayWidgetController * GetOverlayWidgetController(const FWidgetControllerParams& PCparms);
 	
-	void InitOverlay(APlayerController* PC,APlayerState* PS,UAbilitySystemComponent* ASC,UAttributeSet* AS);
+	/**
+	 * 初始化Overlay并为Requester记录一次引用，可以重复调用：
+	 * UI控件只创建一次，参数（PlayerState、ASC等）没有变化时不会重新绑定，只在变化时解绑旧的再绑定新的
+	 * 同一个Requester重复调用只算一次引用
+	 */
+	void InitOverlay(const UObject* Requester,APlayerController* PC,APlayerState* PS,UAbilitySystemComponent* ASC,UAttributeSet* AS);
+
+	//释放Requester的引用，没有任何引用时解绑控制器并把UI从视口移除
+	void ReleaseOverlay(const UObject* Requester);
+
+protected:
+	//HUD创建后立即开始异步加载UI蓝图，InitOverlay时通常已经加载完成
+	virtual void PostInitializeComponents() override;
 
 private:
 	/**
@@ -41,10 +53,14 @@ private:
 	 * 简单说：程序运行时，会根据这个“图纸”创建出上面的OverlayWidget（实际显示的UI）
 	 * EditAnywhere：不用改代码，在编辑器的属性面板里就能选对应的UI蓝图
 	 * 私有化：不让外部代码随便改这个“图纸”，只让HUD自己控制用哪个UI
+	 * 软引用：加载BP_AuraHUD时不会连带同步加载整棵UI控件树，由UAuraAssetPreloadSubsystem异步加载
 	 */
 	UPROPERTY(EditAnywhere)
-	TSubclassOf<UAuraUserWidget> OverlayWidgetClass;
+	TSoftClassPtr<UAuraUserWidget> OverlayWidgetClass;
 	
 	UPROPERTY(EditAnywhere)
-	TSubclassOf<UOverlayWidgetController> OverlayWidgetControllerClass;
+	TSoftClassPtr<UOverlayWidgetController> OverlayWidgetControllerClass;
+
+	//正在使用Overlay的对象（通常是本地玩家角色），为空时Overlay解绑并隐藏
+	TSet<TWeakObjectPtr<const UObject>> OverlayUsers;
 };
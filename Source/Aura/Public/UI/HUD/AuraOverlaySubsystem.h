@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SlateWrapperTypes.h"
+#include "Subsystems/LocalPlayerSubsystem.h"
+#include "AuraOverlaySubsystem.generated.h"
+
+class UAuraUserWidget;
+class UOverlayWidgetController;
+
+/**
+ * @brief 保存本地玩家的Overlay UI控件和它的WidgetController
+ * @details LocalPlayer在重生、切换Pawn、无缝旅行（甚至普通切换地图）时都不会销毁，
+ * 所以控件树只构建一次，AAuraHUD每次InitOverlay只是从这里取出控件并重新绑定到新的ASC和属性集
+ */
+UCLASS()
+class AURA_API UAuraOverlaySubsystem : public ULocalPlayerSubsystem
+{
+	GENERATED_BODY()
+public:
+	virtual void Deinitialize() override;
+
+	//取得Overlay控件，还没有创建或者类不同时按WidgetClass创建
+	UAuraUserWidget* FindOrCreateOverlayWidget(APlayerController* OwningPlayer, TSubclassOf<UAuraUserWidget> WidgetClass);
+
+	//取得Overlay控制器，还没有创建或者类不同时按ControllerClass创建（创建后还没有设置参数和绑定回调）
+	UOverlayWidgetController* FindOrCreateOverlayWidgetController(TSubclassOf<UOverlayWidgetController> ControllerClass);
+
+	//显示Overlay：不在视口中时加入视口，之前被隐藏时恢复可见性
+	void ShowOverlay(APlayerController* OwningPlayer);
+
+	//隐藏Overlay但保留在视口中，下次显示时不需要重新构建（不会再次触发Construct）
+	void HideOverlay();
+
+	UAuraUserWidget* GetOverlayWidget() const { return OverlayWidget; }
+	UOverlayWidgetController* GetOverlayWidgetController() const { return OverlayWidgetController; }
+
+private:
+	UPROPERTY()
+	TObjectPtr<UAuraUserWidget> OverlayWidget;
+
+	UPROPERTY()
+	TObjectPtr<UOverlayWidgetController> OverlayWidgetController;
+
+	//隐藏前的可见性，显示时恢复
+	TOptional<ESlateVisibility> VisibilityBeforeHide;
+};
@@ -57,6 +57,9 @@ public:
 	virtual void BroadcastInitialValues();
 	
 	virtual void BindCallbacksToDependencies();
+
+	//当前保存的参数是否和传入的参数一致，用于跳过重复的初始化
+	bool MatchesWidgetControllerParams(const FWidgetControllerParams& params) const;
 protected:
 	/**
 	 * @brief 关联的玩家控制器（客户端视角的玩家核心控制类）
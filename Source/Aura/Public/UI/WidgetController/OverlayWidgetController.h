@@ -3,6 +3,8 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "AbilitySystem/AuraAttributeSet.h"
+#include "Containers/Ticker.h"
 #include "UI/WidgetController/AuraWidgetController.h"
 #include "OverlayWidgetController.generated.h"
 
@@ -21,6 +23,10 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnManaChangedSignature,float,NewMan
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnMaxManaChangedSignature,float,NewMaxMana);
 
+// 通用的「属性变化」动态多播委托：所有属性共用一个委托，以属性本身作为键
+// 参数说明：Attribute → 发生变化的属性；NewValue → 变化后的最新值
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnAttributeChangedSignature,const FGameplayAttribute&,Attribute,float,NewValue);
+
 /**
  * Overlay UI（血条/蓝条面板）的逻辑控制器
  * 负责属性数据的监听、计算，并通过委托通知UI更新显示
@@ -36,8 +42,42 @@ public:
 	
 	virtual void BindCallbacksToDependencies() override;
 	
+	virtual void BeginDestroy() override;
+	
+	//解绑所有通过BindCallbacksToDependencies注册到ASC上的属性回调
+	void UnbindCallbacksFromDependencies();
+	
 	/**
-	 * 【血量变化委托】- 蓝图可绑定
+	 * 是否合并属性变化广播
+	 * 开启后属性变化只记录到脏掩码中，每帧（或每BroadcastInterval秒）每个属性最多广播一次最新值，
+	 * 持续伤害和回复同时触发时能明显减少蓝图中的UI刷新次数
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "GAS|Attributes")
+	bool bCoalesceAttributeBroadcasts = true;
+	
+	//合并广播的刷新间隔（秒），为0时每帧刷新一次
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "GAS|Attributes", meta = (EditCondition = "bCoalesceAttributeBroadcasts", ClampMin = "0.0"))
+	float BroadcastInterval = 0.0f;
+	
+	/**
+	 * 生命/魔力是否通过旧版单独委托（OnHealthChanged等）广播
+	 * 开启时这四个属性只走旧版委托，不再通过OnAttributeChanged重复广播；关闭时所有属性只走OnAttributeChanged
+	 * 每次变化只触发一次蓝图委托。现有的血球/魔力球控件绑定的是旧版委托，所以默认开启，控件改为绑定通用委托后关闭
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "GAS|Attributes")
+	bool bBroadcastLegacyVitalDelegates = true;
+	
+	/**
+	 * 【通用属性变化委托】- 蓝图可绑定
+	 * 用途：属性集中的任何属性变化都通过这一个委托通知UI，UI按Attribute参数区分是哪个属性
+	 * 新增属性时不需要再声明新的委托，也不需要改动控制器代码
+	 * bBroadcastLegacyVitalDelegates开启时不包含生命/魔力
+	 */
+	UPROPERTY(BlueprintAssignable,Category = "GAS|Attributes")
+	FOnAttributeChangedSignature OnAttributeChanged;
+	
+	/**
+	 * 【血量变化委托】- 蓝图可绑定（旧版，只在bBroadcastLegacyVitalDelegates开启时广播，新控件请绑定OnAttributeChanged）
 	 * 用途：当玩家血量发生变化时，触发该委托通知UI更新血条显示
 	 * BlueprintAssignable：允许在蓝图中绑定该委托的事件（比如UI蓝图里绑定“更新血条进度”逻辑）
 	 * Category = "GAS|Attributes"：在蓝图细节面板中归类，方便查找（GAS=能力系统，Attributes=属性）
@@ -62,11 +102,37 @@ public:
 	UPROPERTY(BlueprintAssignable,Category = "GAS|Attributes")
 	FOnMaxManaChangedSignature OnMaxManaChanged;
 protected:
-	//以下两个函数是当生命值和最大生命值改变的时候会被调用的函数
-	void HealthChanged(const FOnAttributeChangeData& Data) const;
-	void MaxHealthChanged(const FOnAttributeChangeData& Data) const;
+	//所有属性共用的变化回调，BindingIndex是该属性在AttributeBindings中的下标（绑定时作为负载参数传入）
+	void AttributeChanged(const FOnAttributeChangeData& Data, int32 BindingIndex);
+	
+private:
+	//一条属性绑定记录：属性、ASC上的委托句柄、合并广播时等待发送的最新值
+	struct FAttributeBinding
+	{
+		FGameplayAttribute Attribute;
+		FDelegateHandle Handle;
+		//对应的旧版单独委托（OnHealthChanged等），没有时为EAuraVitalIndex::Num
+		EAuraVitalIndex LegacyIndex = EAuraVitalIndex::Num;
+		float PendingValue = 0.0f;
+	};
+	
+	//记录一次属性变化：合并模式下只写入脏掩码，否则立即广播
+	void QueueBroadcast(int32 BindingIndex, float NewValue);
+	
+	//调用对应属性的蓝图委托
+	void BroadcastAttribute(int32 BindingIndex, float NewValue) const;
+	
+	//Ticker回调：把脏掩码中的属性各广播一次，返回false表示一次性Ticker
+	bool FlushPendingBroadcasts(float DeltaTime);
+	
+	//属性绑定表，由属性集类中的所有FGameplayAttribute生成
+	TArray<FAttributeBinding> AttributeBindings;
+	
+	//绑定时使用的ASC，解绑时需要从同一个ASC上移除
+	TWeakObjectPtr<UAbilitySystemComponent> BoundAbilitySystemComponent;
+	
+	//等待广播的属性掩码，下标和AttributeBindings一致
+	TBitArray<> PendingBroadcastBits;
 	
-	//以下两个函数时当魔力值和最大魔力值发生变化的时候会被调用的函数
-	void ManaChanged(const FOnAttributeChangeData& Data) const;
-	void MaxManaChanged(const FOnAttributeChangeData& Data) const;
+	FTSTicker::FDelegateHandle FlushTickerHandle;
 };